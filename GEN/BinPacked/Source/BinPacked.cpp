@@ -1,13 +1,16 @@
 #include "BinPacked.h"
 
+#include <zlib.h>
+
 #include <fstream>
+#include <vector>
 
 namespace GENA
 {
 	void BinPacked::Index::addEntry(ResId resId, const std::string& filename, const std::string resType)
 	{
 		entries[resId].filename = filename;
-		entries[resId].resType = resType;
+		entries[resId].resType = packResourceType(resType);
 		resourceIds.push_back(resId);
 	}
 
@@ -17,6 +20,11 @@ namespace GENA
 		resourceIds.push_back(resId);
 	}
 
+	void BinPacked::Index::setDependencies(ResId resId, const std::vector<ResId>& dependencies)
+	{
+		entries.at(resId).dependencies = dependencies;
+	}
+
 	const BinPacked::Entry& BinPacked::Index::getEntry(ResId id) const
 	{
 		return entries.at(id);
@@ -46,8 +54,9 @@ namespace GENA
 		uint64_t res = sizeof(uint32_t);
 		for (const auto& entryPair : entries)
 		{
-			res += sizeof(ResId) + sizeof(uint64_t) * 2 + 8
-				+ sizeof(uint16_t) + entryPair.second.filename.length();
+			res += sizeof(ResId) + sizeof(uint64_t) * 2 + sizeof(uint32_t) + 8
+				+ sizeof(uint16_t) + entryPair.second.filename.length()
+				+ sizeof(uint16_t) + sizeof(ResId) * entryPair.second.dependencies.size();
 		}
 		return res;
 	}
@@ -68,6 +77,11 @@ namespace GENA
 			throw std::runtime_error("Invalid file size (" + std::to_string(fileSize) + ")");
 		}
 
+		std::vector<char> contents((size_t)fileSize);
+		std::ifstream source(fileEntry.filename, std::ios::binary);
+		source.read(contents.data(), contents.size());
+		fileEntry.checksum = crc32(crc32(0, Z_NULL, 0), (const Bytef*)contents.data(), (uInt)contents.size());
+
 		fileEntry.fileSize = fileSize;
 		fileEntry.filepos = currPos;
 		return currPos + fileSize;
@@ -77,7 +91,27 @@ namespace GENA
 	{
 		this->archive.swap(archive);
 
-		readIndex();
+		readIndex(*this->archive);
+	}
+
+	void BinPacked::bindArchive(const std::string& filepath)
+	{
+		archiveFile.reset(new PositionalFile(filepath));
+
+		// The index comes out of the same open file as the resources, so
+		// both are of one version even if a new archive replaces it meanwhile
+		PositionalStreamBuf indexBuf(*archiveFile);
+		std::istream in(&indexBuf);
+		readIndex(in);
+		if (!in)
+		{
+			throw std::runtime_error(filepath + " has a truncated index");
+		}
+	}
+
+	const PositionalFile* BinPacked::getArchiveFile() const
+	{
+		return archiveFile.get();
 	}
 
 	void BinPacked::prepareFileInfo()
@@ -112,10 +146,26 @@ namespace GENA
 		return index.getEntry(id).fileSize;
 	}
 
+	uint64_t BinPacked::getFilePos(ResId id) const
+	{
+		return index.getEntry(id).filepos;
+	}
+
+	uint32_t BinPacked::getChecksum(ResId id) const
+	{
+		return index.getEntry(id).checksum;
+	}
+
 	void BinPacked::extractFile(ResId id, char* buffer) const
 	{
 		const Entry& entry = index.getEntry(id);
 
+		if (archiveFile)
+		{
+			archiveFile->read(entry.filepos, buffer, entry.fileSize);
+			return;
+		}
+
 		std::lock_guard<std::mutex> lock(archiveLock);
 		archive->seekg(entry.filepos);
 		archive->read(buffer, entry.fileSize);
@@ -126,6 +176,11 @@ namespace GENA
 		return index.getEntries().size();
 	}
 
+	bool BinPacked::hasFile(ResId res) const
+	{
+		return index.getEntries().count(res) != 0;
+	}
+
 	BinPacked::ResId BinPacked::getFileId(uint32_t num) const
 	{
 		return index.getResAt(num);
@@ -137,10 +192,25 @@ namespace GENA
 	}
 
 	std::string BinPacked::getFileType(ResId res) const
+	{
+		return unpackResourceType(index.getEntry(res).resType);
+	}
+
+	ResourceType BinPacked::getFileTypeCode(ResId res) const
 	{
 		return index.getEntry(res).resType;
 	}
 
+	void BinPacked::setDependencies(ResId res, const std::vector<ResId>& dependencies)
+	{
+		index.setDependencies(res, dependencies);
+	}
+
+	const std::vector<BinPacked::ResId>& BinPacked::getDependencies(ResId res) const
+	{
+		return index.getEntry(res).dependencies;
+	}
+
 	void BinPacked::writeFile(std::ostream& out, const Entry& fileEntry)
 	{
 		auto startPos = out.tellp();
@@ -164,15 +234,15 @@ namespace GENA
 		}
 	}
 
-	void BinPacked::readIndex()
+	void BinPacked::readIndex(std::istream& in)
 	{
 		uint32_t numEntries;
-		des(*archive.get(), numEntries);
+		des(in, numEntries);
 
 		for (unsigned int i = 0; i < numEntries; ++i)
 		{
 			std::pair<ResId, Entry> entry;
-			des(*archive.get(), entry);
+			des(in, entry);
 			index.addEntry(entry.first, entry.second);
 		}
 	}
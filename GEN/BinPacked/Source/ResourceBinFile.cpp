@@ -1,46 +1,147 @@
 #include "ResourceBinFile.h"
+#include "PackDiff.h"
 
-#include <fstream>
+#include <iostream>
 
 namespace GENA
 {
+	static std::shared_ptr<MappedFile> mapArchive(const BinPacked& pack)
+	{
+		try
+		{
+			// Mapped through the handle the index was read with, not reopened by path
+			return std::make_shared<MappedFile>(*pack.getArchiveFile());
+		}
+		catch (std::exception& ex)
+		{
+			// Still usable, resources will just be copied out of the file
+			std::cerr << "Archive not mapped: " << ex.what() << std::endl;
+			return std::shared_ptr<MappedFile>();
+		}
+	}
+
 	ResourceBinFile::ResourceBinFile(std::string filepath)
-		: filepath(filepath)
+		: filepath(filepath),
+		pack(std::make_shared<BinPacked>())
 	{
 	}
 
+	std::shared_ptr<BinPacked> ResourceBinFile::getPack() const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return pack;
+	}
+
 	void ResourceBinFile::open()
 	{
-		pack.bindArchive(std::unique_ptr<std::istream>(new std::ifstream(filepath, std::ifstream::binary)));
+		pack->bindArchive(filepath);
+		names.build(*this, [this](ResId res) { return pack->getFileName(res); });
+		mapping = mapArchive(*pack);
 	}
 
 	uint64_t ResourceBinFile::getRawResourceSize(ResId res)
 	{
-		return pack.getFileSize(res);
+		return getPack()->getFileSize(res);
 	}
 
 	void ResourceBinFile::getRawResource(ResId res, char* buffer)
 	{
-		pack.extractFile(res, buffer);
+		getPack()->extractFile(res, buffer);
 	}
 
 	uint32_t ResourceBinFile::getNumResources() const
 	{
-		return pack.getNumFiles();
+		return getPack()->getNumFiles();
 	}
 
 	IResourceFile::ResId ResourceBinFile::getResourceId(uint32_t num) const
 	{
-		return pack.getFileId(num);
+		return getPack()->getFileId(num);
+	}
+
+	const std::string& ResourceBinFile::getResourceName(ResId res) const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return names.getName(res);
 	}
 
-	std::string ResourceBinFile::getResourceName(ResId res) const
+	bool ResourceBinFile::findResource(const std::string& name, ResId& res) const
 	{
-		return pack.getFileName(res);
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return names.find(name, res);
 	}
 
 	std::string ResourceBinFile::getResourceType(ResId res) const
 	{
-		return pack.getFileType(res);
+		return getPack()->getFileType(res);
+	}
+
+	ResourceType ResourceBinFile::getResourceTypeCode(ResId res) const
+	{
+		return getPack()->getFileTypeCode(res);
+	}
+
+	std::vector<IResourceFile::ResId> ResourceBinFile::getResourceDependencies(ResId res) const
+	{
+		return getPack()->getDependencies(res);
+	}
+
+	uint32_t ResourceBinFile::getResourceChecksum(ResId res) const
+	{
+		return getPack()->getChecksum(res);
+	}
+
+	bool ResourceBinFile::mapRawResource(ResId res, MappedView& view)
+	{
+		std::shared_ptr<BinPacked> currentPack;
+		std::shared_ptr<MappedFile> currentMapping;
+		{
+			std::lock_guard<std::mutex> lock(reloadLock);
+			currentPack = pack;
+			currentMapping = mapping;
+		}
+
+		if (!currentMapping)
+		{
+			return false;
+		}
+
+		uint64_t pos = currentPack->getFilePos(res);
+		uint64_t size = currentPack->getFileSize(res);
+		if (pos + size > currentMapping->size())
+		{
+			return false;
+		}
+
+		view.data = currentMapping->data() + pos;
+		view.size = size;
+		view.mapping = currentMapping;
+
+		return true;
+	}
+
+	std::string ResourceBinFile::getFilePath() const
+	{
+		return filepath;
+	}
+
+	bool ResourceBinFile::reload(std::vector<ResId>& changed)
+	{
+		std::shared_ptr<BinPacked> newPack(std::make_shared<BinPacked>());
+		newPack->bindArchive(filepath);
+		std::shared_ptr<MappedFile> newMapping(mapArchive(*newPack));
+
+		std::shared_ptr<BinPacked> oldPack = getPack();
+		diffPacks(*oldPack, *newPack, changed);
+
+		std::lock_guard<std::mutex> lock(reloadLock);
+
+		updateNames(names, *newPack, changed);
+
+		// Reads and handles still holding the old archive and mapping keep them open
+		pack = newPack;
+		mapping = newMapping;
+
+		return true;
 	}
 }
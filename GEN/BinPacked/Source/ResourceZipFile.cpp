@@ -1,47 +1,117 @@
 #include "ResourceZipFile.h"
-
-#include <fstream>
+#include "PackDiff.h"
 
 namespace GENA
 {
 	ResourceZipFile::ResourceZipFile(std::string filepath)
-		:filepath(filepath)
+		:filepath(filepath),
+		pack(std::make_shared<ZipPacked>())
 	{
 	}
 
+	std::shared_ptr<ZipPacked> ResourceZipFile::getPack() const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return pack;
+	}
+
 	void ResourceZipFile::open()
 	{
-		pack.bindArchive(std::unique_ptr<std::istream>(new std::ifstream(filepath, std::ifstream::binary)));
+		pack->bindArchive(filepath);
+		names.build(*this, [this](ResId res) { return pack->getFileName(res); });
 	}
 
 	uint64_t ResourceZipFile::getRawResourceSize(ResId res)
 	{
-		return pack.getFileSize(res);
+		return getPack()->getFileSize(res);
 	}
 
 	void ResourceZipFile::getRawResource(ResId res, char* buffer)
 	{
-		pack.extractFile(res, buffer);
+		getPack()->extractFile(res, buffer);
 	}
 
 	uint32_t ResourceZipFile::getNumResources() const
 	{
-		return pack.getNumFiles();
+		return getPack()->getNumFiles();
 	}
 
 	IResourceFile::ResId ResourceZipFile::getResourceId(uint32_t num) const
 	{
-		return pack.getFileId(num);
+		return getPack()->getFileId(num);
+	}
+
+	const std::string& ResourceZipFile::getResourceName(ResId res) const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return names.getName(res);
 	}
 
-	std::string ResourceZipFile::getResourceName(ResId res) const
+	bool ResourceZipFile::findResource(const std::string& name, ResId& res) const
 	{
-		return pack.getFileName(res);
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return names.find(name, res);
 	}
 
 	std::string ResourceZipFile::getResourceType(ResId res) const
 	{
-		return pack.getFileType(res);
+		return getPack()->getFileType(res);
+	}
+
+	ResourceType ResourceZipFile::getResourceTypeCode(ResId res) const
+	{
+		return getPack()->getFileTypeCode(res);
+	}
+
+	std::vector<IResourceFile::ResId> ResourceZipFile::getResourceDependencies(ResId res) const
+	{
+		return getPack()->getDependencies(res);
+	}
+
+	uint32_t ResourceZipFile::getResourceChecksum(ResId res) const
+	{
+		return getPack()->getChecksum(res);
+	}
+
+	uint64_t ResourceZipFile::getStoredResourceSize(ResId res)
+	{
+		return getPack()->getCompressedSize(res);
 	}
 
+	void ResourceZipFile::getStoredResource(ResId res, char* buffer)
+	{
+		getPack()->readCompressed(res, buffer);
+	}
+
+	bool ResourceZipFile::needsDecode(ResId res) const
+	{
+		return true;
+	}
+
+	void ResourceZipFile::decodeResource(ResId res, const char* stored, uint64_t storedSize, char* buffer)
+	{
+		getPack()->decompress(res, stored, storedSize, buffer);
+	}
+	std::string ResourceZipFile::getFilePath() const
+	{
+		return filepath;
+	}
+
+	bool ResourceZipFile::reload(std::vector<ResId>& changed)
+	{
+		std::shared_ptr<ZipPacked> newPack(std::make_shared<ZipPacked>());
+		newPack->bindArchive(filepath);
+
+		std::shared_ptr<ZipPacked> oldPack = getPack();
+		diffPacks(*oldPack, *newPack, changed);
+
+		std::lock_guard<std::mutex> lock(reloadLock);
+
+		updateNames(names, *newPack, changed);
+
+		// Reads still holding the old archive keep it open
+		pack = newPack;
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -13,7 +13,7 @@ namespace GENA
 	void ZipPacked::Index::addEntry(ResId resId, const std::string& filename, const std::string resType)
 	{
 		entries[resId].filename = filename;
-		entries[resId].resType = resType;
+		entries[resId].resType = packResourceType(resType);
 		resourceIds.push_back(resId);
 	}
 	
@@ -23,6 +23,11 @@ namespace GENA
 		resourceIds.push_back(resId);
 	}
 
+	void ZipPacked::Index::setDependencies(ResId resId, const std::vector<ResId>& dependencies)
+	{
+		entries.at(resId).dependencies = dependencies;
+	}
+
 	const ZipPacked::Entry& ZipPacked::Index::getEntry(ResId id) const
 	{
 		return entries.at(id);
@@ -48,8 +53,9 @@ namespace GENA
 		uint64_t res = sizeof(uint32_t);
 		for(const auto& entryPair : entries)
 		{
-			res += sizeof(ResId) + sizeof(uint64_t) * 3 + 8
-				+ sizeof(uint16_t) + entryPair.second.filename.length();
+			res += sizeof(ResId) + sizeof(uint64_t) * 3 + sizeof(uint32_t) + 8
+				+ sizeof(uint16_t) + entryPair.second.filename.length()
+				+ sizeof(uint16_t) + sizeof(ResId) * entryPair.second.dependencies.size();
 		}
 		return res;
 	}
@@ -58,7 +64,22 @@ namespace GENA
 	{
 		this->archive.swap(archive);
 
-		readIndex();
+		readIndex(*this->archive);
+	}
+
+	void ZipPacked::bindArchive(const std::string& filepath)
+	{
+		archiveFile.reset(new PositionalFile(filepath));
+
+		// The index comes out of the same open file as the resources, so
+		// both are of one version even if a new archive replaces it meanwhile
+		PositionalStreamBuf indexBuf(*archiveFile);
+		std::istream in(&indexBuf);
+		readIndex(in);
+		if (!in)
+		{
+			throw std::runtime_error(filepath + " has a truncated index");
+		}
 	}
 
 	void ZipPacked::write(std::ostream& out)
@@ -102,18 +123,48 @@ namespace GENA
 	void ZipPacked::extractFile(ResId id, char* buffer) const
 	{
 		const Entry& entry = index.getEntry(id);
-		uLongf destLen = (uLongf)entry.fileSize;
-		Bytef *src = (Bytef*)malloc((size_t)entry.compSize);
+		// Freed even if reading or inflating throws
+		std::unique_ptr<char[]> src(new char[(size_t)entry.compSize]);
+
+		readCompressed(id, src.get());
+		decompress(id, src.get(), entry.compSize, buffer);
+	}
+
+	uint32_t ZipPacked::getChecksum(ResId id) const
+	{
+		return index.getEntry(id).checksum;
+	}
+
+	uint64_t ZipPacked::getCompressedSize(ResId id) const
+	{
+		return index.getEntry(id).compSize;
+	}
+
+	void ZipPacked::readCompressed(ResId id, char* buffer) const
+	{
+		const Entry& entry = index.getEntry(id);
 
+		if (archiveFile)
 		{
-			std::lock_guard<std::mutex> lock(archiveLock);
-			archive->seekg(entry.filepos);
-			archive->read((char*)src, entry.compSize);
+			archiveFile->read(entry.filepos, buffer, entry.compSize);
+			return;
 		}
 
-		uncompress((Bytef *)buffer, &destLen, src, (uLongf)entry.compSize);
+		std::lock_guard<std::mutex> lock(archiveLock);
+		archive->seekg(entry.filepos);
+		archive->read(buffer, entry.compSize);
+	}
 
-		free(src);
+	void ZipPacked::decompress(ResId id, const char* compressed, uint64_t compSize, char* buffer) const
+	{
+		const Entry& entry = index.getEntry(id);
+		uLongf destLen = (uLongf)entry.fileSize;
+
+		if (uncompress((Bytef*)buffer, &destLen, (const Bytef*)compressed, (uLongf)compSize) != Z_OK
+			|| destLen != entry.fileSize)
+		{
+			throw std::runtime_error("Failed to decompress " + entry.filename);
+		}
 	}
 
 	uint32_t ZipPacked::getNumFiles() const
@@ -121,6 +172,11 @@ namespace GENA
 		return index.getEntries().size();
 	}
 
+	bool ZipPacked::hasFile(ResId res) const
+	{
+		return index.getEntries().count(res) != 0;
+	}
+
 	ZipPacked::ResId ZipPacked::getFileId(uint32_t num) const
 	{
 		return index.getResAt(num);
@@ -132,10 +188,25 @@ namespace GENA
 	}
 
 	std::string ZipPacked::getFileType(ResId res) const
+	{
+		return unpackResourceType(index.getEntry(res).resType);
+	}
+
+	ResourceType ZipPacked::getFileTypeCode(ResId res) const
 	{
 		return index.getEntry(res).resType;
 	}
 
+	void ZipPacked::setDependencies(ResId res, const std::vector<ResId>& dependencies)
+	{
+		index.setDependencies(res, dependencies);
+	}
+
+	const std::vector<ZipPacked::ResId>& ZipPacked::getDependencies(ResId res) const
+	{
+		return index.getEntry(res).dependencies;
+	}
+
 	void ZipPacked::writeFile(std::ostream& out, Entry& fileEntry)
 	{
 		fileEntry.filepos = out.tellp();
@@ -157,20 +228,21 @@ namespace GENA
 		out.write((char*)dest, destLen);
 		fileEntry.fileSize = length;
 		fileEntry.compSize = destLen;
+		fileEntry.checksum = crc32(crc32(0, Z_NULL, 0), src, (uInt)length);
 
 		free(dest);
 		free(src);
 	}
 
-	void ZipPacked::readIndex()
+	void ZipPacked::readIndex(std::istream& in)
 	{
 		uint32_t numEntries;
-		des(*archive.get(), numEntries);
+		des(in, numEntries);
 
 		for (unsigned int i = 0; i < numEntries; ++i)
 		{
 			std::pair<ResId, Entry> entry;
-			des(*archive.get(), entry);
+			des(in, entry);
 			index.addEntry(entry.first, entry.second);
 		}
 	}
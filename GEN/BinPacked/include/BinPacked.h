@@ -1,5 +1,8 @@
 #pragma once
 
+#include <PositionalFile.h>
+#include <ResourceType.h>
+
 #include <cstdint>
 #include <iostream>
 #include <map>
@@ -20,8 +23,10 @@ namespace GENA
 		{
 			uint64_t filepos;
 			uint64_t fileSize;
-			std::string resType;
+			uint32_t checksum;
+			ResourceType resType;
 			std::string filename;
+			std::vector<ResId> dependencies;
 		};
 
 		class Index
@@ -33,6 +38,7 @@ namespace GENA
 		public:
 			void addEntry(ResId resId, const std::string& filename, const std::string resType);
 			void addEntry(ResId resId, const Entry& entry);
+			void setDependencies(ResId resId, const std::vector<ResId>& dependencies);
 			const Entry& getEntry(ResId id) const;
 			ResId getResAt(uint32_t num) const;
 			const std::map<ResId, Entry>& getEntries() const;
@@ -45,27 +51,60 @@ namespace GENA
 		};
 
 		Index index;
+		// Streams have one position for everyone, so reads through one take turns
 		std::unique_ptr<std::istream> archive;
 		mutable std::mutex archiveLock;
+		std::unique_ptr<PositionalFile> archiveFile;
 
 	public:
+		/**
+		 * Reads the index from archive and extracts files out of it, one
+		 * at a time.
+		 */
 		void bindArchive(std::unique_ptr<std::istream> archive);
 
+		/**
+		 * Opens the archive at filepath for positional reads, which let any
+		 * number of threads extract files at once without locking.
+		 */
+		void bindArchive(const std::string& filepath);
+
+		/**
+		 * The archive bound by filepath, or null. Lets the archive be mapped
+		 * as the very version the index was read from.
+		 */
+		const PositionalFile* getArchiveFile() const;
+
 		void prepareFileInfo();
 		void write(std::ostream& out) const;
 
 		void addFile(ResId id, const std::string& filename, const std::string resType);
 		uint64_t getFileSize(ResId id) const;
+		uint64_t getFilePos(ResId id) const;
+
+		/**
+		 * CRC-32 of the file's contents, taken when the archive was built.
+		 */
+		uint32_t getChecksum(ResId id) const;
 		void extractFile(ResId id, char* buffer) const;
 		uint32_t getNumFiles() const;
+		bool hasFile(ResId res) const;
 		ResId getFileId(uint32_t num) const;
 		std::string getFileName(ResId res) const;
 		std::string getFileType(ResId res) const;
+		ResourceType getFileTypeCode(ResId res) const;
+
+		/**
+		 * Resources that res refers to and that are needed along with it,
+		 * like the textures of a model.
+		 */
+		void setDependencies(ResId res, const std::vector<ResId>& dependencies);
+		const std::vector<ResId>& getDependencies(ResId res) const;
 
 	private:
 		static void writeFile(std::ostream& out, const Entry& fileEntry);
 
-		void readIndex();
+		void readIndex(std::istream& in);
 
 		template <typename ValType>
 		static void ser(std::ostream& out, ValType val);
@@ -100,8 +139,15 @@ namespace GENA
 		{
 			ser(out, val.filepos);
 			ser(out, val.fileSize);
-			out.write(val.resType.data(), 8);
+			ser(out, val.checksum);
+			ser(out, val.resType);
 			ser(out, val.filename);
+
+			ser(out, (uint16_t)val.dependencies.size());
+			for (ResId dep : val.dependencies)
+			{
+				ser(out, dep);
+			}
 		}
 
 		template <>
@@ -144,12 +190,19 @@ namespace GENA
 		{
 			des(in, val.filepos);
 			des(in, val.fileSize);
+			des(in, val.checksum);
 
-			char typeBuf[8];
-			in.read(typeBuf, 8);
-			val.resType.assign(typeBuf, 8);
+			des(in, val.resType);
 
 			des(in, val.filename);
+
+			uint16_t numDeps;
+			des(in, numDeps);
+			val.dependencies.resize(numDeps);
+			for (ResId& dep : val.dependencies)
+			{
+				des(in, dep);
+			}
 		}
 
 		template <>
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ResourceNameIndex.h>
+
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * Finds the files added, removed or changed between two versions of an
+	 * archive, telling changes apart by size, checksum and type. Only
+	 * looks at the indices, the file contents are never read.
+	 */
+	template <typename Pack>
+	void diffPacks(const Pack& oldPack, const Pack& newPack, std::vector<typename Pack::ResId>& changed)
+	{
+		const uint32_t numNew = newPack.getNumFiles();
+		for (uint32_t i = 0; i < numNew; ++i)
+		{
+			const typename Pack::ResId res = newPack.getFileId(i);
+			if (!oldPack.hasFile(res)
+				|| oldPack.getFileSize(res) != newPack.getFileSize(res)
+				|| oldPack.getChecksum(res) != newPack.getChecksum(res)
+				|| oldPack.getFileTypeCode(res) != newPack.getFileTypeCode(res))
+			{
+				changed.push_back(res);
+			}
+		}
+
+		const uint32_t numOld = oldPack.getNumFiles();
+		for (uint32_t i = 0; i < numOld; ++i)
+		{
+			const typename Pack::ResId res = oldPack.getFileId(i);
+			if (!newPack.hasFile(res))
+			{
+				changed.push_back(res);
+			}
+		}
+	}
+
+	/**
+	 * Brings names up to date with the changed files of newPack.
+	 */
+	template <typename Pack>
+	void updateNames(ResourceNameIndex& names, const Pack& newPack, const std::vector<typename Pack::ResId>& changed)
+	{
+		// Removed first, a name may have moved on to a new resource
+		for (auto res : changed)
+		{
+			if (!newPack.hasFile(res))
+			{
+				names.remove(res);
+			}
+		}
+
+		for (auto res : changed)
+		{
+			if (newPack.hasFile(res))
+			{
+				names.set(res, newPack.getFileName(res));
+			}
+		}
+	}
+}
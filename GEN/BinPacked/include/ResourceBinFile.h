@@ -3,6 +3,10 @@
 #include "BinPacked.h"
 
 #include <IResourceFile.h>
+#include <ResourceNameIndex.h>
+#include <MappedFile.h>
+
+#include <mutex>
 
 namespace GENA
 {
@@ -10,7 +14,13 @@ namespace GENA
 	{
 	private:
 		std::string filepath;
-		BinPacked pack;
+		std::shared_ptr<BinPacked> pack;
+		ResourceNameIndex names;
+		std::shared_ptr<MappedFile> mapping;
+		// Held just long enough to copy or swap the above, reads use their copies
+		mutable std::mutex reloadLock;
+
+		std::shared_ptr<BinPacked> getPack() const;
 
 	public:
 		ResourceBinFile(std::string filepath);
@@ -20,7 +30,14 @@ namespace GENA
 		void getRawResource(ResId res, char* buffer) override;
 		uint32_t getNumResources() const override;
 		ResId getResourceId(uint32_t num) const override;
-		std::string getResourceName(ResId res) const override;
+		const std::string& getResourceName(ResId res) const override;
+		bool findResource(const std::string& name, ResId& res) const override;
 		std::string getResourceType(ResId res) const override;
+		ResourceType getResourceTypeCode(ResId res) const override;
+		std::vector<ResId> getResourceDependencies(ResId res) const override;
+		uint32_t getResourceChecksum(ResId res) const override;
+		bool mapRawResource(ResId res, MappedView& view) override;
+		std::string getFilePath() const override;
+		bool reload(std::vector<ResId>& changed) override;
 	};
 }
@@ -3,6 +3,9 @@
 #include "ZipPacked.h"
 
 #include <IResourceFile.h>
+#include <ResourceNameIndex.h>
+
+#include <mutex>
 
 namespace GENA
 {
@@ -10,7 +13,12 @@ namespace GENA
 	{
 	private:
 		std::string filepath;
-		ZipPacked pack;
+		std::shared_ptr<ZipPacked> pack;
+		ResourceNameIndex names;
+		// Held just long enough to copy or swap the above, reads use their copies
+		mutable std::mutex reloadLock;
+
+		std::shared_ptr<ZipPacked> getPack() const;
 
 	public:
 		ResourceZipFile(std::string filepath);
@@ -20,7 +28,19 @@ namespace GENA
 		void getRawResource(ResId res, char* buffer) override;
 		uint32_t getNumResources() const override;
 		ResId getResourceId(uint32_t num) const override;
-		std::string getResourceName(ResId res) const override;
+		const std::string& getResourceName(ResId res) const override;
+		bool findResource(const std::string& name, ResId& res) const override;
 		std::string getResourceType(ResId res) const override;
+		ResourceType getResourceTypeCode(ResId res) const override;
+		std::vector<ResId> getResourceDependencies(ResId res) const override;
+		uint32_t getResourceChecksum(ResId res) const override;
+
+		uint64_t getStoredResourceSize(ResId res) override;
+		void getStoredResource(ResId res, char* buffer) override;
+		bool needsDecode(ResId res) const override;
+		void decodeResource(ResId res, const char* stored, uint64_t storedSize, char* buffer) override;
+
+		std::string getFilePath() const override;
+		bool reload(std::vector<ResId>& changed) override;
 	};
 }
\ No newline at end of file
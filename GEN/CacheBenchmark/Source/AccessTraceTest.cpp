@@ -0,0 +1,61 @@
+#include "AccessTraceTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <AccessTrace.h>
+#include <ResourceCache.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+static const uint32_t numShared = 24;
+static const uint32_t numRooms = 40;
+static const uint32_t perRoom = 16;
+static const uint64_t cacheSizeMiB = 31;
+
+void testAccessTrace()
+{
+	std::cout << "Running access trace test\n";
+
+	MemoryResourceFile* resFile = new MemoryResourceFile(numShared + numRooms * perRoom, 64 * 1024, 1024 * 1024, 12);
+
+	GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+	cache.init();
+	cache.startAccessTrace("accessTrace.bin");
+
+	// Walking forward through the rooms and sometimes turning back, with
+	// shared resources used everywhere and the next room preloaded
+	std::default_random_engine randEng(3);
+	std::uniform_int_distribution<int> turnBack(0, 5);
+
+	int room = 0;
+	for (uint32_t step = 0; step < numRooms * 2; ++step)
+	{
+		room = std::max(0, std::min((int)numRooms - 2, room + (turnBack(randEng) == 0 ? -1 : 1)));
+
+		for (uint32_t i = 0; i < numShared; ++i)
+		{
+			cache.getHandle(resFile->getResourceId(i));
+		}
+		for (uint32_t i = 0; i < perRoom; ++i)
+		{
+			cache.getHandle(resFile->getResourceId(numShared + room * perRoom + i));
+			cache.preload(resFile->getResourceId(numShared + (room + 1) * perRoom + i), nullptr, nullptr);
+		}
+	}
+
+	cache.stopAccessTrace();
+
+	std::vector<GENA::AccessTrace::Record> records = GENA::AccessTrace::read("accessTrace.bin");
+
+	uint64_t counts[4] = { 0, 0, 0, 0 };
+	for (const auto& record : records)
+	{
+		++counts[record.type];
+	}
+
+	std::cout << records.size() << " records: " << counts[GENA::AccessTrace::Request] << " requests, "
+		<< counts[GENA::AccessTrace::Preload] << " preloads, " << counts[GENA::AccessTrace::Load] << " loads, "
+		<< counts[GENA::AccessTrace::Evict] << " evictions" << std::endl;
+}
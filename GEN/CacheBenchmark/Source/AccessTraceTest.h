@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Records the access trace of a player walking through rooms and reads
+ * it back. The trace written, accessTrace.bin, can be replayed with
+ * CacheSimulator.
+ */
+void testAccessTrace();
@@ -0,0 +1,72 @@
+#include "BackgroundEvictionTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 256;
+static const uint64_t cacheSizeMiB = 8;
+static const uint64_t compressedSizeMiB = 16;
+static const unsigned int frameMs = 1;
+
+void testBackgroundEviction()
+{
+	std::cout << "Running background eviction test\n";
+
+	std::ofstream out("backgroundEviction.csv");
+	out << "Background;TimeMs;AvgRequestMs;MaxRequestMs;SyncBatches;SyncEvicted;BackgroundBatches;BackgroundEvicted\n";
+
+	for (int background = 0; background < 2; ++background)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 64 * 1024, 192 * 1024, 10);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		// Evicted resources are compressed as they die, which makes freeing them costly
+		cache.setCompressedTierSize(compressedSizeMiB);
+		cache.setBackgroundEviction(background != 0);
+		cache.init();
+
+		double totalRequestMs = 0.0;
+		double maxRequestMs = 0.0;
+
+		cl::time_point startTime = cl::now();
+
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			cl::time_point requestStart = cl::now();
+			cache.getHandle(resFile->getResourceId(i));
+			double requestMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - requestStart).count() / 1000.0;
+
+			totalRequestMs += requestMs;
+			maxRequestMs = std::max(maxRequestMs, requestMs);
+
+			// The rest of the frame
+			std::this_thread::sleep_for(std::chrono::milliseconds(frameMs));
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		GENA::ResourceCache::PressureStats stats = cache.getPressureStats();
+
+		std::cout << (background ? "With" : "Without") << " background eviction: " << totalRequestMs / numResources
+			<< " ms per request, " << stats.evictionBatches << " evictions on the requesting thread" << std::endl;
+
+		out << background
+			<< ';' << timeMs
+			<< ';' << totalRequestMs / numResources
+			<< ';' << maxRequestMs
+			<< ';' << stats.evictionBatches
+			<< ';' << stats.evicted
+			<< ';' << stats.backgroundBatches
+			<< ';' << stats.backgroundEvicted
+			<< '\n';
+	}
+}
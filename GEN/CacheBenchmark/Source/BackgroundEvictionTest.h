@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Streams resources through a full cache on one thread, like a render
+ * thread walking through rooms, with and without background eviction,
+ * and reports how long its requests took and who did the evicting.
+ */
+void testBackgroundEviction();
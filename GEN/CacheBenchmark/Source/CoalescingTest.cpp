@@ -0,0 +1,182 @@
+#include "CoalescingTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static const uint32_t numResources = 256;
+static const uint64_t cacheSizeMiB = 64;
+
+static const uint32_t numChained = 128;
+static const uint32_t chainStride = 7;
+
+static void countCallback(std::shared_ptr<GENA::ResourceHandle> handle, void* userData)
+{
+	++*static_cast<std::atomic<uint32_t>*>(userData);
+}
+
+struct ChainState
+{
+	GENA::ResourceCache* cache;
+	std::vector<GENA::ResourceCache::ResId> ids;
+	std::atomic<uint32_t> done;
+	std::atomic<uint32_t> failed;
+};
+
+/**
+ * Asks for a resource preloaded a little later, most likely still on its
+ * way through the pipeline, from the completion stage.
+ */
+static void chainCallback(std::shared_ptr<GENA::ResourceHandle> handle, void* userData)
+{
+	ChainState* state = static_cast<ChainState*>(userData);
+
+	const size_t num = std::find(state->ids.begin(), state->ids.end(), handle->getId()) - state->ids.begin();
+	if (!state->cache->getHandle(state->ids[(num + chainStride) % state->ids.size()]))
+	{
+		++state->failed;
+	}
+	++state->done;
+}
+
+static void testCallbackCoalescing()
+{
+	std::ofstream out("coalescingCallbacks.csv");
+	out << "DecodeThreads;Preloads;Loads;Coalesced;PipelineCopies;Failed\n";
+
+	for (unsigned int decodeThreads = 1; decodeThreads <= 2; ++decodeThreads)
+	{
+		ChainState state;
+		state.done = 0;
+		state.failed = 0;
+
+		MemoryResourceFile* resFile = new MemoryResourceFile(numChained, 16 * 1024, 64 * 1024, 4);
+		resFile->setSimulatedCosts(300, 200);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		// Short queues keep the completion stage busy while later loads are still being read
+		cache.setPipelineDepth(2);
+		cache.setDecodeThreads(decodeThreads);
+		cache.init();
+
+		state.cache = &cache;
+		for (uint32_t i = 0; i < numChained; ++i)
+		{
+			state.ids.push_back(resFile->getResourceId(i));
+		}
+
+		for (uint32_t i = 0; i < numChained; ++i)
+		{
+			cache.preload(state.ids[i], &chainCallback, &state);
+		}
+
+		while (state.done < numChained)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		GENA::ResourceCache::LoadStats stats = cache.getLoadStats();
+
+		std::cout << "Callbacks, " << decodeThreads << " decode threads: loads: " << stats.loads
+			<< ", coalesced: " << stats.coalescedRequests << ", copies: " << stats.pipelineCopies << std::endl;
+
+		out << decodeThreads
+			<< ';' << numChained
+			<< ';' << stats.loads
+			<< ';' << stats.coalescedRequests
+			<< ';' << stats.pipelineCopies
+			<< ';' << state.failed
+			<< '\n';
+	}
+}
+
+void testCoalescing()
+{
+	std::cout << "Running request coalescing test\n";
+
+	const unsigned int maxThreads = std::max(2u, std::thread::hardware_concurrency());
+
+	std::ofstream out("coalescing.csv");
+	out << "Threads;Requests;Loads;Coalesced;BytesSaved;MaxWaiters\n";
+
+	for (unsigned int numThreads = 2; numThreads <= maxThreads; numThreads *= 2)
+	{
+		// Outlives the cache, whose destructor waits for the preload workers
+		std::atomic<uint32_t> callbacks(0);
+
+		GENA::ResourceCache cache(cacheSizeMiB,
+			std::unique_ptr<GENA::IResourceFile>(new MemoryResourceFile(numResources, 64 * 1024, 192 * 1024, 2)));
+		cache.init();
+
+		std::vector<GENA::ResourceCache::ResId> ids;
+		{
+			MemoryResourceFile idSource(numResources, 64 * 1024, 192 * 1024, 2);
+			for (uint32_t i = 0; i < numResources; ++i)
+			{
+				ids.push_back(idSource.getResourceId(i));
+			}
+		}
+
+		std::atomic<bool> start(false);
+		std::vector<std::thread> threads;
+
+		for (unsigned int t = 0; t < numThreads; ++t)
+		{
+			threads.push_back(std::thread([&, t]()
+			{
+				while (!start)
+				{
+					std::this_thread::yield();
+				}
+
+				// Every thread walks the same ids in the same order, like
+				// several systems reacting to the same room change
+				for (auto id : ids)
+				{
+					if (t % 2 == 0)
+					{
+						cache.getHandle(id);
+					}
+					else
+					{
+						cache.preload(id, &countCallback, &callbacks);
+					}
+				}
+			}));
+		}
+
+		start = true;
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		GENA::ResourceCache::LoadStats stats = cache.getLoadStats();
+
+		std::cout << "Threads: " << numThreads << ", loads: " << stats.loads
+			<< ", coalesced: " << stats.coalescedRequests << std::endl;
+
+		out << numThreads
+			<< ';' << numThreads * numResources
+			<< ';' << stats.loads
+			<< ';' << stats.coalescedRequests
+			<< ';' << stats.duplicateBytesSaved
+			<< ';' << stats.maxWaiters
+			<< '\n';
+
+		if (numThreads < maxThreads && numThreads * 2 > maxThreads)
+		{
+			numThreads = maxThreads / 2;
+		}
+	}
+
+	testCallbackCoalescing();
+}
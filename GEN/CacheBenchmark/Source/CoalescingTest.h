@@ -0,0 +1,10 @@
+#pragma once
+
+/**
+ * Lets many threads ask for the same cold resources at once, half through
+ * getHandle and half through preload, and reports how many of the
+ * requests were served by a load another thread had already started.
+ * Then has completion callbacks ask for resources still in the pipeline,
+ * which should be served by that same load too.
+ */
+void testCoalescing();
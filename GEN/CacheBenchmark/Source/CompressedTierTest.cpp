@@ -0,0 +1,70 @@
+#include "CompressedTierTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t resourcesPerRoom = 64;
+static const uint64_t cacheSizeMiB = 10;
+static const uint64_t compressedSizeMiB = 8;
+static const unsigned int readMicroSec = 1000;
+static const unsigned int numVisits = 8;
+
+static void writeTier(std::ostream& out, const GENA::ResourceCache::TierStats& stats)
+{
+	out << ';' << stats.hits
+		<< ';' << stats.hitRate
+		<< ';' << stats.avgLatencyMs;
+}
+
+void testCompressedTier()
+{
+	std::cout << "Running compressed tier test\n";
+
+	std::ofstream out("compressedTier.csv");
+	out << "CompressedMiB;TimeMs"
+		<< ";MemoryHits;MemoryHitRate;MemoryLatencyMs"
+		<< ";CompressedHits;CompressedHitRate;CompressedLatencyMs"
+		<< ";FileHits;FileHitRate;FileLatencyMs\n";
+
+	for (int useTier = 0; useTier < 2; ++useTier)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(resourcesPerRoom * 2, 64 * 1024, 192 * 1024, 6);
+		resFile->setSimulatedCosts(readMicroSec, 0);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.setCompressedTierSize(useTier ? compressedSizeMiB : 0);
+		cache.init();
+
+		cl::time_point startTime = cl::now();
+
+		// Each room is about 8 MiB, so every visit pushes the other one out
+		for (unsigned int visit = 0; visit < numVisits; ++visit)
+		{
+			uint32_t first = (visit % 2) * resourcesPerRoom;
+			for (uint32_t i = first; i < first + resourcesPerRoom; ++i)
+			{
+				cache.getHandle(resFile->getResourceId(i));
+			}
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		GENA::ResourceCache::TierStats compressedStats = cache.getTierStats(GENA::ResourceCache::CompressedTier);
+
+		std::cout << (useTier ? "With" : "Without") << " compressed tier: " << timeMs << " ms, "
+			<< compressedStats.hits << " compressed hits" << std::endl;
+
+		out << (useTier ? compressedSizeMiB : 0) << ';' << timeMs;
+		writeTier(out, cache.getTierStats(GENA::ResourceCache::MemoryTier));
+		writeTier(out, compressedStats);
+		writeTier(out, cache.getTierStats(GENA::ResourceCache::FileTier));
+		out << '\n';
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Walks back and forth between two rooms that do not both fit in memory,
+ * with and without a compressed tier, and reports where the resources
+ * came from and how long getting them took.
+ */
+void testCompressedTier();
@@ -0,0 +1,63 @@
+#include "DecodedCacheTest.h"
+
+#include "MemoryResourceFile.h"
+#include "ParsingLoader.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 128;
+static const uint64_t cacheSizeMiB = 64;
+static const unsigned int readMicroSec = 200;
+static const unsigned int parseMicroSec = 2000;
+
+void testDecodedCache()
+{
+	std::cout << "Running decoded disk cache test\n";
+
+	std::ofstream out("decodedCache.csv");
+	out << "Run;TimeMs;Hits;Misses;Stale;Stores\n";
+
+	// A version no earlier benchmark run can have left files for
+	const uint32_t contentVersion = (uint32_t)time(nullptr);
+	const char* runNames[] = { "Cold", "Warm", "Rebuilt" };
+
+	for (int run = 0; run < 3; ++run)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 16 * 1024, 128 * 1024, 7);
+		resFile->setSimulatedCosts(readMicroSec, 0);
+		resFile->setContentVersion(run < 2 ? contentVersion : contentVersion + 1);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.setDecodedCacheDir("decodedCache");
+		cache.init();
+		cache.registerLoader(std::shared_ptr<GENA::IResourceLoader>(new ParsingLoader(parseMicroSec)));
+
+		cl::time_point startTime = cl::now();
+
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			cache.getHandle(resFile->getResourceId(i));
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		GENA::DecodedDiskCache::Stats stats = cache.getDecodedCacheStats();
+
+		std::cout << runNames[run] << ": " << timeMs << " ms, " << stats.hits << " hits" << std::endl;
+
+		out << runNames[run]
+			<< ';' << timeMs
+			<< ';' << stats.hits
+			<< ';' << stats.misses
+			<< ';' << stats.stale
+			<< ';' << stats.stores
+			<< '\n';
+	}
+}
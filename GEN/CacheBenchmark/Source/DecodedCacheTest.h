@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Loads resources through a slow parsing loader three times, each with a
+ * fresh cache: cold, warm from the decoded disk cache left by the first
+ * run, and after the archive contents changed. Reports the time taken and
+ * what the disk cache did.
+ */
+void testDecodedCache();
@@ -0,0 +1,91 @@
+#include "DeferredEvictionTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 60;
+static const uint64_t resourceSize = 100 * 1024;
+static const uint64_t cacheSizeMiB = 4;
+static const uint32_t loadsPerFrame = 10;
+// The cache holds about 40 resources, all of these should still be there
+static const uint32_t numRecent = 30;
+
+void testDeferredEviction()
+{
+	std::cout << "Running deferred eviction test\n";
+
+	std::ofstream out("deferredEviction.csv");
+	out << "Deferred;Policy;TimeMs;Evicted;Overcommits;Rejected;Waits;MaxKiB;RecentHits\n";
+
+	const GENA::ResourceCache::OvercommitPolicy policies[] =
+	{
+		GENA::ResourceCache::EvictUnpinned,
+		GENA::ResourceCache::WaitForRoom
+	};
+	const char* policyNames[] = { "EvictUnpinned", "Wait" };
+
+	for (int deferred = 0; deferred < 2; ++deferred)
+	{
+		for (int p = 0; p < 2; ++p)
+		{
+			MemoryResourceFile* resFile = new MemoryResourceFile(numResources, resourceSize, resourceSize, 11);
+
+			GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+			cache.setOvercommitPolicy(policies[p], 500);
+			cache.setDeferredFree(deferred != 0);
+			cache.init();
+
+			cl::time_point startTime = cl::now();
+
+			for (uint32_t i = 0; i < numResources; ++i)
+			{
+				cache.getHandle(resFile->getResourceId(i));
+
+				// End of the frame, on the same thread that loads
+				if ((i + 1) % loadsPerFrame == 0)
+				{
+					cache.collectGarbage();
+				}
+			}
+
+			double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+			uint32_t recentHits = 0;
+			for (uint32_t i = numResources - numRecent; i < numResources; ++i)
+			{
+				const uint64_t loadsBefore = cache.getLoadStats().loads;
+				cache.getHandle(resFile->getResourceId(i));
+				if (cache.getLoadStats().loads == loadsBefore)
+				{
+					++recentHits;
+				}
+			}
+			cache.collectGarbage();
+
+			GENA::ResourceCache::PressureStats stats = cache.getPressureStats();
+
+			std::cout << (deferred ? "Deferred" : "Immediate") << " free, " << policyNames[p] << ": "
+				<< stats.evicted << " evicted, " << stats.overcommits << " overcommits, "
+				<< recentHits << " of " << numRecent << " recent hits" << std::endl;
+
+			out << deferred
+				<< ';' << policyNames[p]
+				<< ';' << timeMs
+				<< ';' << stats.evicted
+				<< ';' << stats.overcommits
+				<< ';' << stats.rejected
+				<< ';' << stats.waits
+				<< ';' << cache.getMaxMemAllocated() / 1024
+				<< ';' << recentHits
+				<< '\n';
+		}
+	}
+}
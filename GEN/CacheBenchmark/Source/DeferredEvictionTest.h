@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Streams through more resources than the cache holds, dropping every
+ * handle right away, with handles freed immediately and deferred to the
+ * end of the frame. Writes how much was evicted and overcommitted and how
+ * many of the most recent resources were still cached afterwards.
+ */
+void testDeferredEviction();
@@ -0,0 +1,82 @@
+#include "DeferredFreeTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numRooms = 16;
+static const uint32_t resourcesPerRoom = 32;
+static const uint64_t cacheSizeMiB = 6;
+static const uint64_t compressedSizeMiB = 32;
+
+void testDeferredFree()
+{
+	std::cout << "Running deferred free test\n";
+
+	std::ofstream out("deferredFree.csv");
+	out << "Deferred;AvgDropMs;MaxDropMs;AvgCollectMs;MaxCollectMs;Freed;Batches\n";
+
+	for (int deferred = 0; deferred < 2; ++deferred)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(numRooms * resourcesPerRoom, 64 * 1024, 192 * 1024, 10);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		// Resources are compressed as their last handle dies, which makes freeing them costly
+		cache.setCompressedTierSize(compressedSizeMiB);
+		cache.setDeferredFree(deferred != 0);
+		cache.init();
+
+		std::vector<std::shared_ptr<GENA::ResourceHandle>> currentRoom;
+		double totalDropMs = 0.0;
+		double maxDropMs = 0.0;
+		double totalCollectMs = 0.0;
+		double maxCollectMs = 0.0;
+
+		for (uint32_t room = 0; room < numRooms; ++room)
+		{
+			std::vector<std::shared_ptr<GENA::ResourceHandle>> nextRoom;
+			for (uint32_t i = 0; i < resourcesPerRoom; ++i)
+			{
+				nextRoom.push_back(cache.getHandle(resFile->getResourceId(room * resourcesPerRoom + i)));
+			}
+
+			// Leaving the old room, most of it has been evicted by now
+			cl::time_point dropStart = cl::now();
+			currentRoom.swap(nextRoom);
+			nextRoom.clear();
+			double dropMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - dropStart).count() / 1000.0;
+
+			// End of the frame
+			cl::time_point collectStart = cl::now();
+			cache.collectGarbage();
+			double collectMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - collectStart).count() / 1000.0;
+
+			totalDropMs += dropMs;
+			maxDropMs = std::max(maxDropMs, dropMs);
+			totalCollectMs += collectMs;
+			maxCollectMs = std::max(maxCollectMs, collectMs);
+		}
+
+		GENA::ResourceCache::FreeStats stats = cache.getFreeStats();
+
+		std::cout << (deferred ? "Deferred" : "Immediate") << " free: " << totalDropMs / numRooms
+			<< " ms dropping a room, " << totalCollectMs / numRooms << " ms collecting" << std::endl;
+
+		out << deferred
+			<< ';' << totalDropMs / numRooms
+			<< ';' << maxDropMs
+			<< ';' << totalCollectMs / numRooms
+			<< ';' << maxCollectMs
+			<< ';' << stats.freed
+			<< ';' << stats.batches
+			<< '\n';
+	}
+}
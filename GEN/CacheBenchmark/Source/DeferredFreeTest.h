@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Walks through rooms on one thread, dropping the handles of the room left
+ * behind each time, with handles freed immediately and deferred to the end
+ * of the frame, and reports how long dropping them stalled that thread.
+ */
+void testDeferredFree();
@@ -0,0 +1,140 @@
+#include "EvictionPolicyTest.h"
+
+#include <AccessTrace.h>
+#include <ArcEvictionPolicy.h>
+#include <CacheReplay.h>
+#include <LruEvictionPolicy.h>
+#include <TinyLfuEvictionPolicy.h>
+#include <TwoQueueEvictionPolicy.h>
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+typedef GENA::ReplayAccess Access;
+
+/**
+ * Reads the accesses of a trace recorded by ResourceCache::startAccessTrace,
+ * the same way the cache simulator does.
+ */
+static std::vector<Access> loadTrace(const char* traceFile)
+{
+	try
+	{
+		return GENA::extractAccesses(GENA::AccessTrace::read(traceFile));
+	}
+	catch (std::exception& ex)
+	{
+		std::cerr << ex.what() << '\n';
+		return std::vector<Access>();
+	}
+}
+
+/**
+ * A player sprinting forward through rooms and sometimes turning back.
+ * Every room uses a shared set of shaders and default textures, a set of
+ * props shared by neighbouring rooms, and a few resources used nowhere else.
+ */
+static std::vector<Access> generateSprintTrace()
+{
+	std::cout << "Generating room sprint trace\n";
+
+	const unsigned int numRooms = 200;
+	const unsigned int numShared = 24;
+	const unsigned int numProps = 60;
+	const unsigned int propsPerRoom = 12;
+	const unsigned int uniquePerRoom = 20;
+
+	std::default_random_engine randEng(1);
+	std::uniform_int_distribution<uint64_t> sharedSize(16 * 1024, 512 * 1024);
+	std::uniform_int_distribution<uint64_t> propSize(64 * 1024, 1024 * 1024);
+	std::uniform_int_distribution<uint64_t> uniqueSize(256 * 1024, 2 * 1024 * 1024);
+	std::uniform_int_distribution<unsigned int> propDist(0, numProps - 1);
+	std::uniform_int_distribution<unsigned int> turnBack(0, 9);
+
+	std::vector<Access> shared(numShared);
+	for (unsigned int i = 0; i < numShared; ++i)
+	{
+		shared[i].res = 1 + i;
+		shared[i].size = sharedSize(randEng);
+	}
+
+	std::vector<Access> props(numProps);
+	for (unsigned int i = 0; i < numProps; ++i)
+	{
+		props[i].res = 1000 + i;
+		props[i].size = propSize(randEng);
+	}
+
+	std::vector<uint64_t> uniqueSizes(numRooms * uniquePerRoom);
+	for (auto& size : uniqueSizes)
+	{
+		size = uniqueSize(randEng);
+	}
+
+	std::vector<Access> trace;
+	int room = 0;
+	for (unsigned int step = 0; step < numRooms * 2; ++step)
+	{
+		room += turnBack(randEng) == 0 ? -1 : 1;
+		unsigned int roomIndex = (unsigned int)((room % (int)numRooms + numRooms) % numRooms);
+
+		for (const Access& access : shared)
+		{
+			trace.push_back(access);
+		}
+
+		std::default_random_engine roomEng(roomIndex);
+		for (unsigned int i = 0; i < propsPerRoom; ++i)
+		{
+			trace.push_back(props[propDist(roomEng)]);
+		}
+
+		for (unsigned int i = 0; i < uniquePerRoom; ++i)
+		{
+			Access access = { 100000 + roomIndex * uniquePerRoom + i, uniqueSizes[roomIndex * uniquePerRoom + i] };
+			trace.push_back(access);
+		}
+	}
+
+	return trace;
+}
+
+void testEvictionPolicies(const char* traceFile)
+{
+	std::cout << "Running eviction policy trace replay\n";
+
+	std::vector<Access> trace = traceFile ? loadTrace(traceFile) : generateSprintTrace();
+	if (trace.empty())
+	{
+		return;
+	}
+
+	GENA::EvictionPolicyFactory factories[] =
+	{
+		&GENA::LruEvictionPolicy::create,
+		&GENA::TwoQueueEvictionPolicy::create,
+		&GENA::ArcEvictionPolicy::create,
+		&GENA::TinyLfuEvictionPolicy::create,
+	};
+
+	std::ofstream out("evictionPolicies.csv");
+	out << "Policy;CacheMiB;HitRate;BytesReloaded\n";
+
+	for (GENA::EvictionPolicyFactory factory : factories)
+	{
+		for (uint64_t cacheMiB = 8; cacheMiB <= 128; cacheMiB *= 2)
+		{
+			std::unique_ptr<GENA::IEvictionPolicy> policy = factory();
+			GENA::ReplayResult result = GENA::replayAccesses(trace, *policy, cacheMiB * 1024 * 1024);
+
+			double hitRate = (double)result.hits / (result.hits + result.misses);
+			std::cout << policy->getName() << " " << cacheMiB << " MiB: hit rate " << hitRate
+				<< ", reloaded " << result.bytesReloaded / (1024 * 1024) << " MiB\n";
+
+			out << policy->getName() << ';' << cacheMiB << ';' << hitRate << ';' << result.bytesReloaded << '\n';
+		}
+	}
+}
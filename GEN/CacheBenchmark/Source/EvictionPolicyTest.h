@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Replays an access trace against every eviction policy for a range of
+ * cache sizes. traceFile is a trace recorded by
+ * ResourceCache::startAccessTrace, or nullptr to use a generated room
+ * sprint trace.
+ */
+void testEvictionPolicies(const char* traceFile);
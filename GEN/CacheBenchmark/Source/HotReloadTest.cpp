@@ -0,0 +1,97 @@
+#include "HotReloadTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 4096;
+static const uint32_t changedCounts[] = { 1, 16, 256, 4096 };
+
+static bool hasContents(const GENA::ResourceHandle& handle, char expected)
+{
+	const GENA::Buffer& buffer = handle.getBuffer();
+	return buffer.size() > 0 && buffer.data()[0] == expected && buffer.data()[buffer.size() - 1] == expected;
+}
+
+static void checkStaleHandles(GENA::ResourceCache& cache, MemoryResourceFile& resFile)
+{
+	const GENA::IResourceFile::ResId res = resFile.getResourceId(0);
+	const GENA::IResourceFile::ResId untouched = resFile.getResourceId(1);
+
+	std::shared_ptr<GENA::ResourceHandle> old = cache.getHandle(res);
+	std::shared_ptr<GENA::ResourceHandle> kept = cache.getHandle(untouched);
+	const char oldContents = old->getBuffer().data()[0];
+
+	resFile.modifyResource(res);
+	if (cache.reloadFile() != 1)
+	{
+		throw std::runtime_error("Reload did not find the one resource changed");
+	}
+
+	if (!old->isStale() || !hasContents(*old, oldContents))
+	{
+		throw std::runtime_error("Handle held across a reload lost its old contents");
+	}
+
+	std::shared_ptr<GENA::ResourceHandle> fresh = cache.getHandle(res);
+	if (fresh == old || fresh->isStale() || !hasContents(*fresh, (char)(oldContents + 1)))
+	{
+		throw std::runtime_error("Resource asked for after a reload is not the new version");
+	}
+
+	if (kept->isStale() || cache.getHandle(untouched) != kept)
+	{
+		throw std::runtime_error("Reload invalidated a resource that did not change");
+	}
+}
+
+void testHotReload()
+{
+	std::cout << "Running hot reload test\n";
+
+	MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 4 * 1024, 4 * 1024, 23);
+	GENA::ResourceCache cache(64, std::unique_ptr<GENA::IResourceFile>(resFile));
+	cache.init();
+
+	checkStaleHandles(cache, *resFile);
+
+	std::ofstream out("hotReload.csv");
+	out << "Changed;ReloadMs;RefetchMs\n";
+
+	for (uint32_t numChanged : changedCounts)
+	{
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			cache.getHandle(resFile->getResourceId(i));
+		}
+
+		for (uint32_t i = 0; i < numChanged; ++i)
+		{
+			resFile->modifyResource(resFile->getResourceId(i));
+		}
+
+		if (cache.reloadFile() != numChanged)
+		{
+			throw std::runtime_error("Reload found a different number of changes than made");
+		}
+		double reloadMs = cache.getReloadStats().lastReloadMs;
+
+		cl::time_point startTime = cl::now();
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			cache.getHandle(resFile->getResourceId(i));
+		}
+		double refetchMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		out << numChanged << ';' << reloadMs << ';' << refetchMs << '\n';
+		std::cout << numChanged << " changed: reload " << reloadMs << " ms, refetch " << refetchMs << " ms" << std::endl;
+	}
+}
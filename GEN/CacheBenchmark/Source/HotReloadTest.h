@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Reloads a resource file with growing numbers of resources changed and
+ * writes how long the reload and loading the changed resources again took
+ * as CSV. Checks that handles held across a reload keep the old contents
+ * and that everything asked for afterwards has the new ones.
+ */
+void testHotReload();
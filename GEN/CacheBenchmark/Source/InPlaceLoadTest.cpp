@@ -0,0 +1,107 @@
+#include "InPlaceLoadTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 256;
+static const uint64_t cacheSizeMiB = 64;
+static const unsigned int parseMicroSec = 500;
+
+static void parse()
+{
+	cl::time_point endTime = cl::now() + std::chrono::microseconds(parseMicroSec);
+	while (cl::now() < endTime)
+	{
+	}
+}
+
+/**
+ * Stands in for a text format without a header, like rooms, where the
+ * loaded size is only known after parsing everything.
+ */
+class TextLoader : public GENA::IResourceLoader
+{
+private:
+	bool onePass;
+
+public:
+	explicit TextLoader(bool onePass)
+		: onePass(onePass)
+	{
+	}
+
+	std::string getPattern() override { return "raw     "; }
+	bool useRawFile() override { return false; }
+
+	uint64_t getLoadedResourceSize(const GENA::Buffer& rawBuffer) override
+	{
+		parse();
+		return rawBuffer.size();
+	}
+
+	bool loadResource(const GENA::Buffer& rawBuffer, std::shared_ptr<GENA::ResourceHandle> handle) override
+	{
+		parse();
+		memcpy(handle->getBuffer().data(), rawBuffer.data(), rawBuffer.size());
+		return true;
+	}
+
+	std::shared_ptr<GENA::ResourceHandle> load(const GENA::Buffer& rawBuffer, GENA::ILoadTarget& target) override
+	{
+		if (!onePass)
+		{
+			return IResourceLoader::load(rawBuffer, target);
+		}
+
+		parse();
+		std::shared_ptr<GENA::ResourceHandle> handle = target.allocate(rawBuffer.size());
+		if (handle)
+		{
+			memcpy(handle->getBuffer().data(), rawBuffer.data(), rawBuffer.size());
+		}
+		return handle;
+	}
+};
+
+void testInPlaceLoad()
+{
+	std::cout << "Running in place load test\n";
+
+	std::ofstream out("inPlaceLoad.csv");
+	out << "Loader;TimeMs;MsPerLoad\n";
+
+	const char* loaderNames[] = { "TwoPass", "OnePass" };
+
+	for (int onePass = 0; onePass < 2; ++onePass)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 16 * 1024, 64 * 1024, 5);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.init();
+		cache.registerLoader(std::shared_ptr<GENA::IResourceLoader>(new TextLoader(onePass != 0)));
+
+		cl::time_point startTime = cl::now();
+
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			if (!cache.getHandle(resFile->getResourceId(i)))
+			{
+				throw std::runtime_error("In place load failed");
+			}
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		std::cout << loaderNames[onePass] << ": " << timeMs << " ms" << std::endl;
+		out << loaderNames[onePass] << ';' << timeMs << ';' << timeMs / numResources << '\n';
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Loads resources of a format that has to be parsed to know its loaded
+ * size, once with a loader parsing for the size and again for the
+ * contents, and once with a loader doing both in one pass through
+ * IResourceLoader::load. Writes the load times as CSV.
+ */
+void testInPlaceLoad();
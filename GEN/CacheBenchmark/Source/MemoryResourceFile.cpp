@@ -0,0 +1,165 @@
+#include "MemoryResourceFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+MemoryResourceFile::MemoryResourceFile(uint32_t numResources, uint64_t minSize, uint64_t maxSize, unsigned int seed,
+	const std::string& namePrefix)
+	: readMicroSec(0),
+	decodeMicroSec(0),
+	contentVersion(1)
+{
+	std::default_random_engine randEng(seed);
+	std::uniform_int_distribution<uint64_t> sizeDist(minSize, maxSize);
+
+	while (resourceIds.size() < numResources)
+	{
+		ResId id = randEng();
+		if (entries.count(id) != 0)
+		{
+			continue;
+		}
+
+		Entry& entry = entries[id];
+		entry.size = sizeDist(randEng);
+		entry.name = namePrefix + std::to_string((unsigned long long)resourceIds.size());
+		entry.type = "raw     ";
+		entry.typeCode = GENA::packResourceType(entry.type);
+		entry.version = 0;
+		resourceIds.push_back(id);
+	}
+}
+
+void MemoryResourceFile::setSimulatedCosts(unsigned int readMicroSec, unsigned int decodeMicroSec)
+{
+	this->readMicroSec = readMicroSec;
+	this->decodeMicroSec = decodeMicroSec;
+}
+
+void MemoryResourceFile::setDependencies(ResId res, const std::vector<ResId>& dependencies)
+{
+	entries.at(res).dependencies = dependencies;
+}
+
+void MemoryResourceFile::setResourceType(ResId res, const std::string& type)
+{
+	Entry& entry = entries.at(res);
+	entry.type = type;
+	entry.typeCode = GENA::packResourceType(type);
+}
+
+void MemoryResourceFile::setContentVersion(uint32_t version)
+{
+	contentVersion = version;
+}
+
+void MemoryResourceFile::modifyResource(ResId res)
+{
+	++entries.at(res).version;
+	modified.push_back(res);
+}
+
+void MemoryResourceFile::open()
+{
+	names.build(*this, [this](ResId res) { return entries.at(res).name; });
+}
+
+uint64_t MemoryResourceFile::getRawResourceSize(ResId res)
+{
+	return entries.at(res).size;
+}
+
+void MemoryResourceFile::getRawResource(ResId res, char* buffer)
+{
+	const Entry& entry = entries.at(res);
+	memset(buffer, (int)((res + entry.version) & 0xff), (size_t)entry.size);
+}
+
+uint32_t MemoryResourceFile::getNumResources() const
+{
+	return resourceIds.size();
+}
+
+GENA::IResourceFile::ResId MemoryResourceFile::getResourceId(uint32_t num) const
+{
+	return resourceIds[num];
+}
+
+const std::string& MemoryResourceFile::getResourceName(ResId res) const
+{
+	return entries.at(res).name;
+}
+
+bool MemoryResourceFile::findResource(const std::string& name, ResId& res) const
+{
+	return names.find(name, res);
+}
+
+std::string MemoryResourceFile::getResourceType(ResId res) const
+{
+	return entries.at(res).type;
+}
+
+GENA::ResourceType MemoryResourceFile::getResourceTypeCode(ResId res) const
+{
+	return entries.at(res).typeCode;
+}
+
+uint64_t MemoryResourceFile::getStoredResourceSize(ResId res)
+{
+	uint64_t size = entries.at(res).size;
+	return needsDecode(res) ? (size + 1) / 2 : size;
+}
+
+void MemoryResourceFile::getStoredResource(ResId res, char* buffer)
+{
+	if (readMicroSec > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(readMicroSec));
+	}
+
+	memset(buffer, (int)((res + entries.at(res).version) & 0xff), (size_t)getStoredResourceSize(res));
+}
+
+bool MemoryResourceFile::needsDecode(ResId res) const
+{
+	return decodeMicroSec > 0;
+}
+
+void MemoryResourceFile::decodeResource(ResId res, const char* stored, uint64_t storedSize, char* buffer)
+{
+	typedef std::chrono::high_resolution_clock cl;
+
+	cl::time_point endTime = cl::now() + std::chrono::microseconds(decodeMicroSec);
+	while (cl::now() < endTime)
+	{
+	}
+
+	memset(buffer, stored[0], (size_t)entries.at(res).size);
+}
+
+std::vector<GENA::IResourceFile::ResId> MemoryResourceFile::getResourceDependencies(ResId res) const
+{
+	return entries.at(res).dependencies;
+}
+
+uint32_t MemoryResourceFile::getResourceChecksum(ResId res) const
+{
+	// Contents are generated from the id, so id, size and versions say it all
+	const Entry& entry = entries.at(res);
+	return (res * 2654435761u) ^ (uint32_t)entry.size ^ (contentVersion << 16) ^ (entry.version * 2246822519u);
+}
+
+bool MemoryResourceFile::reload(std::vector<ResId>& changed)
+{
+	std::sort(modified.begin(), modified.end());
+	modified.erase(std::unique(modified.begin(), modified.end()), modified.end());
+
+	changed.insert(changed.end(), modified.begin(), modified.end());
+	modified.clear();
+
+	return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <IResourceFile.h>
+#include <ResourceNameIndex.h>
+
+#include <map>
+#include <vector>
+
+/**
+ * A resource file kept entirely in memory, filled with generated
+ * resources. Used to drive the cache without touching the disk.
+ */
+class MemoryResourceFile : public GENA::IResourceFile
+{
+private:
+	struct Entry
+	{
+		uint64_t size;
+		std::string name;
+		std::string type;
+		GENA::ResourceType typeCode;
+		uint32_t version;
+		std::vector<ResId> dependencies;
+	};
+
+	std::vector<ResId> resourceIds;
+	std::map<ResId, Entry> entries;
+	GENA::ResourceNameIndex names;
+	std::vector<ResId> modified;
+
+	unsigned int readMicroSec;
+	unsigned int decodeMicroSec;
+	uint32_t contentVersion;
+
+public:
+	/**
+	 * Generates numResources resources with sizes evenly distributed
+	 * between minSize and maxSize bytes. The same seed always gives
+	 * the same set of resources. Resources are named namePrefix followed
+	 * by their number.
+	 */
+	MemoryResourceFile(uint32_t numResources, uint64_t minSize, uint64_t maxSize, unsigned int seed,
+		const std::string& namePrefix = "generated/");
+
+	/**
+	 * Makes every stored resource read take readMicroSec of waiting, like a
+	 * disk, and, if decodeMicroSec is not 0, stores resources at half size
+	 * and makes decoding them take decodeMicroSec of busy work.
+	 */
+	void setSimulatedCosts(unsigned int readMicroSec, unsigned int decodeMicroSec);
+
+	void setDependencies(ResId res, const std::vector<ResId>& dependencies);
+
+	/**
+	 * Resources are of type "raw     " unless set to something else.
+	 */
+	void setResourceType(ResId res, const std::string& type);
+
+	/**
+	 * Changes the checksum of every resource, as if the file was rebuilt
+	 * with new contents.
+	 */
+	void setContentVersion(uint32_t version);
+
+	/**
+	 * Gives res new contents, picked up by the next reload.
+	 */
+	void modifyResource(ResId res);
+
+	void open() override;
+	uint64_t getRawResourceSize(ResId res) override;
+	void getRawResource(ResId res, char* buffer) override;
+	uint32_t getNumResources() const override;
+	ResId getResourceId(uint32_t num) const override;
+	const std::string& getResourceName(ResId res) const override;
+	bool findResource(const std::string& name, ResId& res) const override;
+	std::string getResourceType(ResId res) const override;
+	GENA::ResourceType getResourceTypeCode(ResId res) const override;
+
+	uint64_t getStoredResourceSize(ResId res) override;
+	void getStoredResource(ResId res, char* buffer) override;
+	bool needsDecode(ResId res) const override;
+	void decodeResource(ResId res, const char* stored, uint64_t storedSize, char* buffer) override;
+	std::vector<ResId> getResourceDependencies(ResId res) const override;
+	uint32_t getResourceChecksum(ResId res) const override;
+	bool reload(std::vector<ResId>& changed) override;
+};
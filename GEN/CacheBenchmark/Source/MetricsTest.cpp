@@ -0,0 +1,109 @@
+#include "MetricsTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 1024;
+static const uint32_t requestsPerThread = 4000;
+static const unsigned int numThreads = 4;
+static const uint64_t cacheSizeMiB = 16;
+static const unsigned int sampleMs = 10;
+
+void testMetrics()
+{
+	std::cout << "Running metrics test\n";
+
+	MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 4 * 1024, 128 * 1024, 11);
+	resFile->setSimulatedCosts(50, 100);
+
+	// A few types of resources of different sizes, for separate latencies
+	static const char* const types[] = { "texture ", "model   ", "sound   " };
+	for (uint32_t i = 0; i < numResources; ++i)
+	{
+		resFile->setResourceType(resFile->getResourceId(i), types[i % 3]);
+	}
+
+	GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+	cache.init();
+
+	std::atomic<unsigned int> running(numThreads);
+	std::vector<std::thread> threads;
+
+	for (unsigned int t = 0; t < numThreads; ++t)
+	{
+		threads.push_back(std::thread([&, t]()
+		{
+			// Skewed towards the first resources, so there are hits as well as misses
+			std::default_random_engine randEng(t);
+			std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+			for (uint32_t i = 0; i < requestsPerThread; ++i)
+			{
+				double r = dist(randEng);
+				uint32_t index = (uint32_t)(r * r * numResources);
+				if (i % 8 == 0)
+				{
+					cache.preload(resFile->getResourceId(index), nullptr, nullptr);
+				}
+				else
+				{
+					cache.getHandle(resFile->getResourceId(index));
+				}
+			}
+
+			--running;
+		}));
+	}
+
+	std::ofstream out("metrics.csv");
+	out << "TimeMs;";
+	GENA::CacheMetrics::writeCounterHeader(out);
+
+	cl::time_point startTime = cl::now();
+	uint64_t snapshotUs = 0;
+	uint32_t snapshots = 0;
+
+	GENA::CacheMetrics::Snapshot snapshot;
+	do
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(sampleMs));
+
+		cl::time_point snapshotStart = cl::now();
+		snapshot = cache.getMetrics();
+		snapshotUs += std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - snapshotStart).count();
+		++snapshots;
+
+		out << std::chrono::duration_cast<std::chrono::milliseconds>(cl::now() - startTime).count() << ';';
+		GENA::CacheMetrics::writeCounterRow(out, snapshot);
+	} while (running > 0);
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	snapshot = cache.getMetrics();
+
+	std::ofstream latencyOut("metricsLatency.csv");
+	GENA::CacheMetrics::writeLatencyCsv(latencyOut, snapshot);
+
+	std::cout << "Hit rate " << snapshot.hitRate << ", " << snapshot.counters[GENA::CacheMetrics::Loads] << " loads, "
+		<< snapshot.counters[GENA::CacheMetrics::Evictions] << " evictions, "
+		<< (double)snapshotUs / snapshots << " us per snapshot" << std::endl;
+	for (const auto& latency : snapshot.latencies)
+	{
+		std::cout << latency.type << ": " << latency.loads << " loads, p50 " << latency.getPercentileMs(0.5)
+			<< " ms, p99 " << latency.getPercentileMs(0.99) << " ms" << std::endl;
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Runs a mixed workload on several threads while sampling the cache
+ * metrics like a HUD would, writing the counters over time and the load
+ * latencies per resource type as CSV.
+ */
+void testMetrics();
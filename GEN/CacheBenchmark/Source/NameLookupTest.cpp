@@ -0,0 +1,70 @@
+#include "NameLookupTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t resourceCounts[] = { 256, 1024, 4096, 16384 };
+static const uint32_t lookups = 20000;
+
+static double lookupNs(const MemoryResourceFile& resFile, const std::vector<std::string>& names, bool indexed)
+{
+	const uint32_t numRes = names.size();
+	cl::time_point startTime = cl::now();
+	for (uint32_t i = 0; i < lookups; ++i)
+	{
+		// Strided, so both ends of the file get looked up
+		const std::string& name = names[(i * 7919) % numRes];
+
+		GENA::IResourceFile::ResId res = 0;
+		bool found = indexed ? resFile.findResource(name, res) : resFile.IResourceFile::findResource(name, res);
+		if (!found)
+		{
+			throw std::runtime_error("Name lookup failed for " + name);
+		}
+	}
+	cl::time_point endTime = cl::now();
+
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() / lookups;
+}
+
+void testNameLookup()
+{
+	std::cout << "Running name lookup test\n";
+
+	std::ofstream out("nameLookup.csv");
+	out << "Resources;ScanNs;IndexNs\n";
+
+	for (uint32_t numRes : resourceCounts)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(numRes, 1024, 1024, 17);
+		GENA::ResourceCache cache(1, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.init();
+
+		std::vector<std::string> names;
+		for (uint32_t i = 0; i < numRes; ++i)
+		{
+			GENA::IResourceFile::ResId res = resFile->getResourceId(i);
+			names.push_back(cache.findPath(res));
+			if (cache.findByPath(names.back()) != res)
+			{
+				throw std::runtime_error("Name index maps " + names.back() + " to the wrong resource");
+			}
+		}
+
+		double scanNs = lookupNs(*resFile, names, false);
+		double indexNs = lookupNs(*resFile, names, true);
+
+		out << numRes << ';' << scanNs << ';' << indexNs << '\n';
+		std::cout << numRes << " resources: " << scanNs << " ns scanning, " << indexNs << " ns indexed" << std::endl;
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Looks up every resource by name, once by scanning all resources and
+ * once through the index built when the file is opened, and writes the
+ * time per lookup for growing numbers of resources as CSV.
+ */
+void testNameLookup();
@@ -0,0 +1,129 @@
+#include "OvercommitTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 96;
+static const uint64_t cacheSizeMiB = 8;
+static const unsigned int releaseMicroSec = 2000;
+
+struct PressureLog
+{
+	unsigned int changes;
+	unsigned int criticals;
+};
+
+static void pressureChanged(GENA::ResourceCache::PressureLevel level, uint64_t allocated, uint64_t cacheSize, void* userData)
+{
+	PressureLog* log = static_cast<PressureLog*>(userData);
+	++log->changes;
+	if (level == GENA::ResourceCache::PressureCritical)
+	{
+		++log->criticals;
+	}
+}
+
+void testOvercommit()
+{
+	std::cout << "Running overcommit test\n";
+
+	std::ofstream out("overcommit.csv");
+	out << "Policy;TimeMs;Loaded;MaxMiB;EvictionBatches;Evicted;Overcommits;Rejected;Waits;WaitMs;PressureChanges;Criticals\n";
+
+	const GENA::ResourceCache::OvercommitPolicy policies[] =
+	{
+		GENA::ResourceCache::EvictUnpinned,
+		GENA::ResourceCache::RejectOvercommit,
+		GENA::ResourceCache::WaitForRoom,
+	};
+	const char* policyNames[] = { "EvictUnpinned", "Reject", "Wait" };
+
+	for (int p = 0; p < 3; ++p)
+	{
+		PressureLog log = { 0, 0 };
+
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 64 * 1024, 192 * 1024, 9);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.setOvercommitPolicy(policies[p], 500);
+		cache.setPressureCallback(&pressureChanged, &log);
+		cache.init();
+
+		// Everything loaded stays in use until the releaser lets go of it,
+		// about twice what the cache holds
+		std::vector<std::shared_ptr<GENA::ResourceHandle>> inUse;
+		std::mutex inUseLock;
+		bool done = false;
+
+		std::thread releaser([&]()
+		{
+			for (;;)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(releaseMicroSec));
+
+				std::lock_guard<std::mutex> lock(inUseLock);
+				if (!inUse.empty())
+				{
+					inUse.erase(inUse.begin());
+				}
+				else if (done)
+				{
+					break;
+				}
+			}
+		});
+
+		cl::time_point startTime = cl::now();
+		uint32_t loaded = 0;
+
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			std::shared_ptr<GENA::ResourceHandle> handle = cache.getHandle(resFile->getResourceId(i));
+			if (handle)
+			{
+				++loaded;
+
+				std::lock_guard<std::mutex> lock(inUseLock);
+				inUse.push_back(handle);
+			}
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		{
+			std::lock_guard<std::mutex> lock(inUseLock);
+			done = true;
+		}
+		releaser.join();
+
+		GENA::ResourceCache::PressureStats stats = cache.getPressureStats();
+
+		std::cout << policyNames[p] << ": " << loaded << " of " << numResources << " loaded, "
+			<< stats.overcommits << " overcommits" << std::endl;
+
+		out << policyNames[p]
+			<< ';' << timeMs
+			<< ';' << loaded
+			<< ';' << cache.getMaxMemAllocated() / (1024.0 * 1024.0)
+			<< ';' << stats.evictionBatches
+			<< ';' << stats.evicted
+			<< ';' << stats.overcommits
+			<< ';' << stats.rejected
+			<< ';' << stats.waits
+			<< ';' << stats.totalWaitMs
+			<< ';' << log.changes
+			<< ';' << log.criticals
+			<< '\n';
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Keeps more resources in use than the cache holds, under every
+ * overcommit policy, and reports how the cache coped and which pressure
+ * levels it went through.
+ */
+void testOvercommit();
@@ -0,0 +1,162 @@
+#include "OverlayTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <OverlayResourceFile.h>
+#include <ResourceCache.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numBaseResources = 4096;
+static const uint32_t numPatchResources = 256;
+static const uint32_t numDlcResources = 512;
+static const unsigned int patchCounts[] = { 1, 2, 4, 8 };
+static const uint32_t lookups = 20000;
+
+// The same seed and sizes give the same resources, patches hold the first few of the base
+static const unsigned int baseSeed = 29;
+static const unsigned int dlcSeed = 31;
+
+static MemoryResourceFile* createPatch(uint32_t numRes)
+{
+	MemoryResourceFile* patch = new MemoryResourceFile(numRes, 1024, 4096, baseSeed);
+	for (uint32_t i = 0; i < numRes; ++i)
+	{
+		patch->modifyResource(patch->getResourceId(i));
+	}
+
+	return patch;
+}
+
+static void checkOverlay(GENA::ResourceCache& cache, const MemoryResourceFile& base, const MemoryResourceFile& dlc)
+{
+	const GENA::IResourceFile::ResId patched = base.getResourceId(0);
+	const GENA::IResourceFile::ResId unpatched = base.getResourceId(numPatchResources);
+	const GENA::IResourceFile::ResId added = dlc.getResourceId(0);
+
+	// Contents are the low byte of the id, plus one for every patch over it
+	if (cache.getHandle(patched)->getBuffer().data()[0] != (char)(patched + 1))
+	{
+		throw std::runtime_error("Patched resource was not taken from the patch");
+	}
+
+	if (cache.getHandle(unpatched)->getBuffer().data()[0] != (char)unpatched)
+	{
+		throw std::runtime_error("Resource only in the base was not taken from the base");
+	}
+
+	if (cache.getHandle(added)->getBuffer().data()[0] != (char)added)
+	{
+		throw std::runtime_error("Resource added by the DLC was not found");
+	}
+
+	if (cache.findByPath(cache.findPath(unpatched)) != unpatched)
+	{
+		throw std::runtime_error("Merged name index maps a name to the wrong resource");
+	}
+}
+
+static double probeNs(const std::vector<const GENA::IResourceFile*>& files, const std::vector<std::string>& names)
+{
+	const uint32_t numNames = names.size();
+	cl::time_point startTime = cl::now();
+	for (uint32_t i = 0; i < lookups; ++i)
+	{
+		const std::string& name = names[(i * 7919) % numNames];
+
+		// Highest priority first, the way a lookup without a merged index goes
+		GENA::IResourceFile::ResId res = 0;
+		bool found = false;
+		for (size_t file = 0; file < files.size() && !found; ++file)
+		{
+			found = files[file]->findResource(name, res);
+		}
+		if (!found)
+		{
+			throw std::runtime_error("Probing found no file with " + name);
+		}
+	}
+	cl::time_point endTime = cl::now();
+
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() / lookups;
+}
+
+static double mergedNs(const GENA::IResourceFile& overlay, const std::vector<std::string>& names)
+{
+	const uint32_t numNames = names.size();
+	cl::time_point startTime = cl::now();
+	for (uint32_t i = 0; i < lookups; ++i)
+	{
+		const std::string& name = names[(i * 7919) % numNames];
+
+		GENA::IResourceFile::ResId res = 0;
+		if (!overlay.findResource(name, res))
+		{
+			throw std::runtime_error("Merged index has no " + name);
+		}
+	}
+	cl::time_point endTime = cl::now();
+
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() / lookups;
+}
+
+void testOverlay()
+{
+	std::cout << "Running overlay test\n";
+
+	std::ofstream out("overlay.csv");
+	out << "Patches;OpenMs;ProbeNs;MergedNs\n";
+
+	for (unsigned int numPatches : patchCounts)
+	{
+		MemoryResourceFile* base = new MemoryResourceFile(numBaseResources, 1024, 4096, baseSeed);
+		MemoryResourceFile* dlc = new MemoryResourceFile(numDlcResources, 1024, 4096, dlcSeed, "dlc/");
+
+		GENA::OverlayResourceFile* overlay = new GENA::OverlayResourceFile();
+		overlay->mount(std::unique_ptr<GENA::IResourceFile>(base), 0);
+		overlay->mount(std::unique_ptr<GENA::IResourceFile>(dlc), 1);
+
+		// Highest priority first
+		std::vector<const GENA::IResourceFile*> files;
+		for (unsigned int i = 0; i < numPatches; ++i)
+		{
+			MemoryResourceFile* patch = createPatch(numPatchResources);
+			overlay->mount(std::unique_ptr<GENA::IResourceFile>(patch), 2);
+			files.insert(files.begin(), patch);
+		}
+		files.push_back(dlc);
+		files.push_back(base);
+
+		GENA::ResourceCache cache(64, std::unique_ptr<GENA::IResourceFile>(overlay));
+
+		cl::time_point startTime = cl::now();
+		cache.init();
+		double openMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		if (overlay->getNumResources() != numBaseResources + numDlcResources)
+		{
+			throw std::runtime_error("Overlay does not hold every resource exactly once");
+		}
+
+		checkOverlay(cache, *base, *dlc);
+
+		std::vector<std::string> names;
+		for (uint32_t i = 0; i < overlay->getNumResources(); ++i)
+		{
+			names.push_back(overlay->getResourceName(overlay->getResourceId(i)));
+		}
+
+		double probe = probeNs(files, names);
+		double indexed = mergedNs(*overlay, names);
+
+		out << numPatches << ';' << openMs << ';' << probe << ';' << indexed << '\n';
+		std::cout << numPatches << " patches: open " << openMs << " ms, " << probe << " ns probing, " << indexed << " ns merged" << std::endl;
+	}
+}
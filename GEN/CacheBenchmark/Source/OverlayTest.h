@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Mounts a base file with growing numbers of patch files on top and
+ * writes the time per lookup through the merged index, and through
+ * probing the files one by one, as CSV. Checks that patched resources
+ * come from the patches and everything else from the base.
+ */
+void testOverlay();
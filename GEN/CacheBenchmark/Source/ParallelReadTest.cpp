@@ -0,0 +1,128 @@
+#include "ParallelReadTest.h"
+
+#include <BinPacked.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numFiles = 256;
+static const uint32_t fileSize = 256 * 1024;
+static const unsigned int threadCounts[] = { 1, 2, 4, 8 };
+static const unsigned int rounds = 4;
+static const char* const archiveName = "parallelRead.bin";
+
+static std::string getSourceName(uint32_t num)
+{
+	return "parallelRead" + std::to_string((unsigned long long)num) + ".dat";
+}
+
+static void createArchive()
+{
+	GENA::BinPacked pack;
+
+	std::vector<char> contents(fileSize);
+	for (uint32_t i = 0; i < numFiles; ++i)
+	{
+		// Every file is filled with its number, for checking what was read
+		std::fill(contents.begin(), contents.end(), (char)i);
+
+		std::ofstream source(getSourceName(i), std::ios::binary | std::ios::trunc);
+		source.write(contents.data(), contents.size());
+		source.close();
+
+		pack.addFile(i + 1, getSourceName(i), "raw");
+	}
+
+	pack.prepareFileInfo();
+
+	std::ofstream archive(archiveName, std::ios::binary | std::ios::trunc);
+	pack.write(archive);
+}
+
+static void removeArchive()
+{
+	for (uint32_t i = 0; i < numFiles; ++i)
+	{
+		std::remove(getSourceName(i).c_str());
+	}
+	std::remove(archiveName);
+}
+
+static double readMiBs(const GENA::BinPacked& pack, unsigned int numThreads)
+{
+	std::atomic<bool> corrupt(false);
+	std::vector<std::thread> threads;
+
+	cl::time_point startTime = cl::now();
+	for (unsigned int t = 0; t < numThreads; ++t)
+	{
+		threads.push_back(std::thread([&, t]()
+		{
+			std::vector<char> buffer(fileSize);
+			for (unsigned int round = 0; round < rounds; ++round)
+			{
+				for (uint32_t i = t; i < numFiles; i += numThreads)
+				{
+					const GENA::BinPacked::ResId res = pack.getFileId(i);
+					pack.extractFile(res, buffer.data());
+					if (buffer.front() != (char)(res - 1) || buffer.back() != (char)(res - 1))
+					{
+						corrupt = true;
+					}
+				}
+			}
+		}));
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	double seconds = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000000.0;
+
+	if (corrupt)
+	{
+		throw std::runtime_error("Parallel extraction read the wrong bytes");
+	}
+
+	return (double)numFiles * fileSize * rounds / (1024 * 1024) / seconds;
+}
+
+void testParallelRead()
+{
+	std::cout << "Running parallel read test\n";
+
+	createArchive();
+
+	{
+		GENA::BinPacked streamPack;
+		streamPack.bindArchive(std::unique_ptr<std::istream>(new std::ifstream(archiveName, std::ifstream::binary)));
+
+		GENA::BinPacked positionalPack;
+		positionalPack.bindArchive(std::string(archiveName));
+
+		std::ofstream out("parallelRead.csv");
+		out << "Threads;StreamMiBs;PositionalMiBs\n";
+
+		for (unsigned int numThreads : threadCounts)
+		{
+			double streamMiBs = readMiBs(streamPack, numThreads);
+			double positionalMiBs = readMiBs(positionalPack, numThreads);
+
+			out << numThreads << ';' << streamMiBs << ';' << positionalMiBs << '\n';
+			std::cout << numThreads << " threads: " << streamMiBs << " MiB/s shared stream, " << positionalMiBs << " MiB/s positional" << std::endl;
+		}
+	}
+
+	removeArchive();
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Builds an archive on disk and extracts every file from it on growing
+ * numbers of threads, once through a shared stream and once through
+ * positional reads, writing the throughput of both as CSV.
+ */
+void testParallelRead();
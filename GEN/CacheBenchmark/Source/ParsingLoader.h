@@ -0,0 +1,40 @@
+#pragma once
+
+#include <IResourceLoader.h>
+
+#include <chrono>
+#include <cstring>
+
+/**
+ * Stands in for a text format that takes a while to parse, like rooms.
+ * Takes over every generated resource once registered.
+ */
+class ParsingLoader : public GENA::IResourceLoader
+{
+private:
+	unsigned int parseMicroSec;
+
+public:
+	explicit ParsingLoader(unsigned int parseMicroSec)
+		: parseMicroSec(parseMicroSec)
+	{
+	}
+
+	std::string getPattern() override { return "raw     "; }
+	bool useRawFile() override { return false; }
+	uint64_t getLoadedResourceSize(const GENA::Buffer& rawBuffer) override { return rawBuffer.size(); }
+	uint32_t getVersion() override { return 1; }
+
+	bool loadResource(const GENA::Buffer& rawBuffer, std::shared_ptr<GENA::ResourceHandle> handle) override
+	{
+		typedef std::chrono::high_resolution_clock cl;
+
+		cl::time_point endTime = cl::now() + std::chrono::microseconds(parseMicroSec);
+		while (cl::now() < endTime)
+		{
+		}
+
+		memcpy(handle->getBuffer().data(), rawBuffer.data(), rawBuffer.size());
+		return true;
+	}
+};
@@ -0,0 +1,84 @@
+#include "PipelineTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 512;
+static const uint64_t cacheSizeMiB = 256;
+static const unsigned int readMicroSec = 200;
+static const unsigned int decodeMicroSec = 1000;
+
+static void countCallback(std::shared_ptr<GENA::ResourceHandle> handle, void* userData)
+{
+	++*static_cast<std::atomic<uint32_t>*>(userData);
+}
+
+static void writeStage(std::ostream& out, const GENA::ResourceCache::StageStats& stats)
+{
+	out << ';' << stats.avgWaitMs
+		<< ';' << stats.avgWorkMs
+		<< ';' << stats.maxQueueDepth;
+}
+
+void testPipeline()
+{
+	std::cout << "Running pipeline streaming test\n";
+
+	const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::ofstream out("pipeline.csv");
+	out << "DecodeThreads;TimeMs"
+		<< ";IoWaitMs;IoWorkMs;IoMaxDepth"
+		<< ";DecodeWaitMs;DecodeWorkMs;DecodeMaxDepth"
+		<< ";CompletionWaitMs;CompletionWorkMs;CompletionMaxDepth\n";
+
+	for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		std::atomic<uint32_t> loaded(0);
+
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 16 * 1024, 256 * 1024, 4);
+		resFile->setSimulatedCosts(readMicroSec, decodeMicroSec);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.setDecodeThreads(numThreads);
+		cache.init();
+
+		cl::time_point startTime = cl::now();
+
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			cache.preload(resFile->getResourceId(i), &countCallback, &loaded);
+		}
+
+		while (loaded < numResources)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		std::cout << "Decode threads: " << numThreads << ", " << timeMs << " ms" << std::endl;
+
+		out << numThreads << ';' << timeMs;
+		writeStage(out, cache.getStageStats(GENA::ResourceCache::IoStage));
+		writeStage(out, cache.getStageStats(GENA::ResourceCache::DecodeStage));
+		writeStage(out, cache.getStageStats(GENA::ResourceCache::CompletionStage));
+		out << '\n';
+
+		if (numThreads < maxThreads && numThreads * 2 > maxThreads)
+		{
+			numThreads = maxThreads / 2;
+		}
+	}
+}
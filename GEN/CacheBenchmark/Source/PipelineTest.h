@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Streams a room's worth of resources through preload from a simulated
+ * slow, compressed archive with increasing numbers of decode threads and
+ * reports how busy each pipeline stage was.
+ */
+void testPipeline();
@@ -0,0 +1,190 @@
+#include "RoomPrefetchTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+#include <RoomPrefetcher.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+typedef GENA::ResourceCache::ResId ResId;
+
+static const int numRooms = 16;
+static const int modelsPerRoom = 4;
+static const int texturesPerModel = 2;
+static const int numModels = numRooms * 2 + 2;
+static const int numTextures = numModels * texturesPerModel;
+static const float roomSize = 10.f;
+static const uint64_t cacheSizeMiB = 12;
+static const int numRuns = 4;
+// The last two look further ahead than the cache holds, limited by the
+// default budget and not limited at all
+static const unsigned int lookaheads[numRuns] = { 0, 2, 10, 10 };
+// Negative leaves the prefetcher's default, half the cache
+static const int64_t budgets[numRuns] = { 6 * 1024 * 1024, 6 * 1024 * 1024, -1, 0 };
+static const unsigned int readMicroSec = 2000;
+
+static void roomLoaded(const std::string& name, bool complete, void* userData)
+{
+	*static_cast<std::atomic<bool>*>(userData) = true;
+}
+
+static ResId resolveRoom(int roomNr, void* userData)
+{
+	const MemoryResourceFile* resFile = static_cast<const MemoryResourceFile*>(userData);
+	return resFile->getResourceId(std::min(std::max(roomNr, 0), numRooms - 1));
+}
+
+/**
+ * Rooms are the first resources, followed by models and then textures.
+ * Neighbouring rooms share half their models, the way adjacent rooms
+ * share furniture.
+ */
+static MemoryResourceFile* createWorld()
+{
+	MemoryResourceFile* resFile = new MemoryResourceFile(numRooms + numModels + numTextures, 64 * 1024, 256 * 1024, 5);
+	resFile->setSimulatedCosts(readMicroSec, 0);
+
+	for (int model = 0; model < numModels; ++model)
+	{
+		std::vector<ResId> textures;
+		for (int i = 0; i < texturesPerModel; ++i)
+		{
+			textures.push_back(resFile->getResourceId(numRooms + numModels + model * texturesPerModel + i));
+		}
+		resFile->setDependencies(resFile->getResourceId(numRooms + model), textures);
+	}
+
+	for (int room = 0; room < numRooms; ++room)
+	{
+		std::vector<ResId> models;
+		for (int i = 0; i < modelsPerRoom; ++i)
+		{
+			models.push_back(resFile->getResourceId(numRooms + room * 2 + i));
+		}
+		resFile->setDependencies(resFile->getResourceId(room), models);
+	}
+
+	return resFile;
+}
+
+void testRoomPrefetch()
+{
+	std::cout << "Running room prefetch test\n";
+
+	std::ofstream out("roomPrefetch.csv");
+	out << "Lookahead;BudgetMiB;Rooms;Stalls;TotalStallMs;MaxStallMs;RoomsPrefetched;MiBPrefetched;Overcommits;MaxMiB\n";
+
+	for (int run = 0; run < numRuns; ++run)
+	{
+		const unsigned int lookahead = lookaheads[run];
+		const bool usePrefetch = lookahead > 0;
+
+		MemoryResourceFile* resFile = createWorld();
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.init();
+
+		GENA::RoomPrefetcher prefetcher(cache, roomSize, &resolveRoom, resFile);
+		prefetcher.setLookahead(lookahead);
+		if (budgets[run] >= 0)
+		{
+			prefetcher.setMemoryBudget(budgets[run]);
+		}
+		const uint64_t budget = budgets[run] < 0 ? cacheSizeMiB * 1024 * 1024 / 2 : budgets[run];
+
+		for (int room = 0; room < numRooms; ++room)
+		{
+			cache.defineSet("room " + std::to_string((long long)room), cache.getDependencyClosure(resFile->getResourceId(room)));
+		}
+
+		int currentRoom = -1;
+		int stalls = 0;
+		double totalStallMs = 0.0;
+		double maxStallMs = 0.0;
+
+		float position = 0.5f;
+		cl::time_point lastFrame = cl::now();
+		double time = 0.0;
+
+		while (position < numRooms * roomSize)
+		{
+			cl::time_point now = cl::now();
+			float deltaTime = std::chrono::duration_cast<std::chrono::microseconds>(now - lastFrame).count() / 1000000.f;
+			lastFrame = now;
+			time += deltaTime;
+
+			// Alternates between strolling and running through the rooms
+			float velocity = 40.f + 25.f * (float)std::sin(time * 2.0);
+			position += velocity * deltaTime;
+
+			int room = (int)(position / roomSize);
+			if (room != currentRoom && room < numRooms)
+			{
+				std::atomic<bool> loaded(false);
+				std::string name("room " + std::to_string((long long)room));
+
+				cl::time_point stallStart = cl::now();
+				cache.loadSet(name, &roomLoaded, &loaded);
+				if (!loaded)
+				{
+					while (!loaded)
+					{
+						std::this_thread::yield();
+					}
+
+					double stallMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - stallStart).count() / 1000.0;
+					++stalls;
+					totalStallMs += stallMs;
+					maxStallMs = std::max(maxStallMs, stallMs);
+				}
+
+				if (currentRoom >= 0)
+				{
+					cache.releaseSet("room " + std::to_string((long long)currentRoom));
+				}
+				currentRoom = room;
+
+				// The stall is not part of the walk
+				lastFrame = cl::now();
+			}
+
+			if (usePrefetch)
+			{
+				prefetcher.update(position, velocity);
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+		}
+
+		cache.releaseSet("room " + std::to_string((long long)currentRoom));
+		prefetcher.clear();
+
+		GENA::RoomPrefetcher::Stats stats = prefetcher.getStats();
+
+		GENA::ResourceCache::PressureStats pressure = cache.getPressureStats();
+
+		std::cout << "Lookahead " << lookahead << ": " << stalls << " stalls, "
+			<< totalStallMs << " ms stalled, " << pressure.overcommits << " overcommits" << std::endl;
+
+		out << lookahead
+			<< ';' << budget / (1024.0 * 1024.0)
+			<< ';' << numRooms
+			<< ';' << stalls
+			<< ';' << totalStallMs
+			<< ';' << maxStallMs
+			<< ';' << stats.roomsPrefetched
+			<< ';' << stats.bytesRequested / (1024.0 * 1024.0)
+			<< ';' << pressure.overcommits
+			<< ';' << cache.getMaxMemAllocated() / (1024.0 * 1024.0)
+			<< '\n';
+	}
+}
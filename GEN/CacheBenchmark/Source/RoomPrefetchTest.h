@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * Moves a camera through a row of generated rooms at varying speed and
+ * measures how long entering each room stalls waiting for its resources,
+ * without the room prefetcher, with it looking a little ahead and with it
+ * looking further ahead than the cache holds.
+ */
+void testRoomPrefetch();
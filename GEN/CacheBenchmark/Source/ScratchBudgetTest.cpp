@@ -0,0 +1,96 @@
+#include "ScratchBudgetTest.h"
+
+#include "MemoryResourceFile.h"
+#include "ParsingLoader.h"
+
+#include <ResourceCache.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 192;
+static const uint64_t cacheSizeMiB = 256;
+static const unsigned int numThreads = 8;
+static const unsigned int readMicroSec = 100;
+static const unsigned int decodeMicroSec = 500;
+static const unsigned int parseMicroSec = 1500;
+
+static void countCallback(std::shared_ptr<GENA::ResourceHandle> handle, void* userData)
+{
+	++*static_cast<std::atomic<uint32_t>*>(userData);
+}
+
+void testScratchBudget()
+{
+	std::cout << "Running scratch budget test\n";
+
+	std::ofstream out("scratchBudget.csv");
+	out << "LimitMiB;TimeMs;PeakScratchMiB;PeakTotalMiB;AdmissionWaits;WaitMs\n";
+
+	// 0 stands for no limit worth mentioning
+	const uint64_t limits[] = { 0, 16, 4 };
+
+	for (uint64_t limit : limits)
+	{
+		std::atomic<uint32_t> preloaded(0);
+
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 256 * 1024, 1024 * 1024, 8);
+		resFile->setSimulatedCosts(readMicroSec, decodeMicroSec);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.setScratchLimit(limit != 0 ? limit : cacheSizeMiB);
+		cache.init();
+		cache.registerLoader(std::shared_ptr<GENA::IResourceLoader>(new ParsingLoader(parseMicroSec)));
+
+		cl::time_point startTime = cl::now();
+
+		// Half is preloaded in one burst while threads ask for the other half
+		for (uint32_t i = 0; i < numResources / 2; ++i)
+		{
+			cache.preload(resFile->getResourceId(i), &countCallback, &preloaded);
+		}
+
+		std::vector<std::thread> threads;
+		for (unsigned int t = 0; t < numThreads; ++t)
+		{
+			threads.push_back(std::thread([&, t]()
+			{
+				for (uint32_t i = numResources / 2 + t; i < numResources; i += numThreads)
+				{
+					cache.getHandle(resFile->getResourceId(i));
+				}
+			}));
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		while (preloaded < numResources / 2)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		GENA::ResourceCache::ScratchStats stats = cache.getScratchStats();
+		const double toMiB = 1.0 / (1024 * 1024);
+
+		std::cout << "Scratch limit " << stats.limit * toMiB << " MiB: " << timeMs << " ms, peak "
+			<< stats.peak * toMiB << " MiB" << std::endl;
+
+		out << stats.limit * toMiB
+			<< ';' << timeMs
+			<< ';' << stats.peak * toMiB
+			<< ';' << stats.peakTotal * toMiB
+			<< ';' << stats.admissionWaits
+			<< ';' << stats.totalWaitMs
+			<< '\n';
+	}
+}
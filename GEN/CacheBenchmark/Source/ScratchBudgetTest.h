@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Streams large compressed, parsed resources through the cache from
+ * several threads at once with different scratch limits and reports the
+ * peak memory held outside the cache and how long loads waited for it.
+ */
+void testScratchBudget();
@@ -0,0 +1,121 @@
+#include "ShardedCacheTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 2048;
+static const uint64_t cacheSizeMiB = 24;
+
+/**
+ * Hammers the cache from numThreads threads for testTimeSec seconds.
+ * Accesses are skewed so that most of them go to a hot fifth of the
+ * resources, like a game revisiting shared assets.
+ *
+ * @returns the total number of getHandle calls per second.
+ */
+static double runThroughputTest(unsigned int numShards, unsigned int numThreads, float testTimeSec)
+{
+	GENA::ResourceCache cache(cacheSizeMiB,
+		std::unique_ptr<GENA::IResourceFile>(new MemoryResourceFile(numResources, 4 * 1024, 28 * 1024, 1)),
+		numShards);
+	cache.init();
+
+	std::vector<GENA::ResourceCache::ResId> ids;
+	{
+		MemoryResourceFile idSource(numResources, 4 * 1024, 28 * 1024, 1);
+		for (uint32_t i = 0; i < numResources; ++i)
+		{
+			ids.push_back(idSource.getResourceId(i));
+		}
+	}
+
+	std::atomic<bool> start(false);
+	std::atomic<bool> stop(false);
+	std::vector<uint64_t> opCounts(numThreads);
+	std::vector<std::thread> threads;
+
+	for (unsigned int t = 0; t < numThreads; ++t)
+	{
+		threads.push_back(std::thread([&, t]()
+		{
+			std::default_random_engine randEng(t + 1);
+			std::uniform_int_distribution<uint32_t> hotDist(0, numResources / 5 - 1);
+			std::uniform_int_distribution<uint32_t> allDist(0, numResources - 1);
+			std::uniform_int_distribution<uint32_t> coin(0, 9);
+
+			uint64_t ops = 0;
+
+			while (!start)
+			{
+				std::this_thread::yield();
+			}
+
+			while (!stop)
+			{
+				uint32_t pick = coin(randEng) < 8 ? hotDist(randEng) : allDist(randEng);
+				cache.getHandle(ids[pick]);
+				++ops;
+			}
+
+			opCounts[t] = ops;
+		}));
+	}
+
+	cl::time_point startTime = cl::now();
+	start = true;
+	std::this_thread::sleep_for(std::chrono::milliseconds((unsigned int)(testTimeSec * 1000.f)));
+	stop = true;
+	cl::time_point stopTime = cl::now();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	uint64_t totalOps = 0;
+	for (uint64_t ops : opCounts)
+	{
+		totalOps += ops;
+	}
+
+	return totalOps / std::chrono::duration<double>(stopTime - startTime).count();
+}
+
+void testShardedCache()
+{
+	std::cout << "Running sharded cache throughput test\n";
+
+	const float runTimePerTestSec = 2.0f;
+	const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	const unsigned int numShards = maxThreads * 4;
+
+	std::ofstream out("shardedCache.csv");
+	out << "Threads;Unsharded;Sharded" << numShards << '\n';
+
+	for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		std::cout << "Threads: " << numThreads << std::endl;
+
+		out << numThreads
+			<< ';' << runThroughputTest(1, numThreads, runTimePerTestSec)
+			<< ';' << runThroughputTest(numShards, numThreads, runTimePerTestSec)
+			<< '\n';
+
+		if (numThreads < maxThreads && numThreads * 2 > maxThreads)
+		{
+			numThreads = maxThreads / 2;
+		}
+	}
+}
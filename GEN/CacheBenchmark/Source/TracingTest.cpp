@@ -0,0 +1,71 @@
+#include "TracingTest.h"
+
+#include "MemoryResourceFile.h"
+
+#include <ResourceCache.h>
+#include <Trace.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+typedef std::chrono::high_resolution_clock cl;
+
+static const uint32_t numResources = 2048;
+static const uint32_t numRequests = 50000;
+static const uint64_t cacheSizeMiB = 1;
+
+void testTracing()
+{
+	std::cout << "Running tracing test\n";
+
+	std::ofstream out("tracing.csv");
+	out << "Level;TimeMs;NsPerRequest;Recorded;Overwritten\n";
+
+	static const GENA::Trace::Level levels[] = { GENA::Trace::Off, GENA::Trace::Info, GENA::Trace::Verbose };
+	static const char* const levelNames[] = { "Off", "Info", "Verbose" };
+	static const size_t numLevels = sizeof(levels) / sizeof(levels[0]);
+
+	for (size_t level = 0; level < numLevels; ++level)
+	{
+		MemoryResourceFile* resFile = new MemoryResourceFile(numResources, 512, 2048, 0);
+
+		GENA::ResourceCache cache(cacheSizeMiB, std::unique_ptr<GENA::IResourceFile>(resFile));
+		cache.init();
+
+		GENA::Trace::clear();
+		GENA::Trace::setLevel(levels[level]);
+
+		// Small resources in a small cache, so there are plenty of loads and evictions
+		uint32_t seed = 1;
+		cl::time_point startTime = cl::now();
+
+		for (uint32_t i = 0; i < numRequests; ++i)
+		{
+			seed = seed * 1664525 + 1013904223;
+			cache.getHandle(resFile->getResourceId((seed >> 8) % numResources));
+		}
+
+		double timeMs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count() / 1000.0;
+
+		GENA::Trace::setLevel(GENA::Trace::Off);
+		GENA::Trace::Stats stats = GENA::Trace::getStats();
+
+		std::cout << levelNames[level] << ": " << timeMs * 1000000.0 / numRequests << " ns per request, "
+			<< stats.recorded << " events" << std::endl;
+
+		out << levelNames[level]
+			<< ';' << timeMs
+			<< ';' << timeMs * 1000000.0 / numRequests
+			<< ';' << stats.recorded
+			<< ';' << stats.overwritten
+			<< '\n';
+
+		if (level + 1 == numLevels)
+		{
+			cache.exportTrace("cacheTrace.json");
+		}
+	}
+
+	GENA::Trace::clear();
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+/**
+ * Requests many small resources at each trace level and reports what
+ * tracing costs per request. Exports the last run as Chrome trace JSON.
+ */
+void testTracing();
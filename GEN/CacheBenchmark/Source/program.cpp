@@ -0,0 +1,46 @@
+#include "AccessTraceTest.h"
+#include "BackgroundEvictionTest.h"
+#include "CoalescingTest.h"
+#include "CompressedTierTest.h"
+#include "DecodedCacheTest.h"
+#include "DeferredEvictionTest.h"
+#include "DeferredFreeTest.h"
+#include "EvictionPolicyTest.h"
+#include "HotReloadTest.h"
+#include "InPlaceLoadTest.h"
+#include "MetricsTest.h"
+#include "NameLookupTest.h"
+#include "OvercommitTest.h"
+#include "OverlayTest.h"
+#include "ParallelReadTest.h"
+#include "PipelineTest.h"
+#include "RoomPrefetchTest.h"
+#include "ScratchBudgetTest.h"
+#include "ShardedCacheTest.h"
+#include "TracingTest.h"
+
+int main(int argc, char* argv[])
+{
+	testShardedCache();
+	testEvictionPolicies(argc > 1 ? argv[1] : nullptr);
+	testCoalescing();
+	testPipeline();
+	testRoomPrefetch();
+	testCompressedTier();
+	testDecodedCache();
+	testScratchBudget();
+	testOvercommit();
+	testBackgroundEviction();
+	testDeferredFree();
+	testDeferredEviction();
+	testTracing();
+	testMetrics();
+	testAccessTrace();
+	testNameLookup();
+	testInPlaceLoad();
+	testHotReload();
+	testOverlay();
+	testParallelRead();
+
+	return 0;
+}
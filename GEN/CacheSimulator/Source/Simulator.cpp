@@ -0,0 +1,54 @@
+#include "Simulator.h"
+
+#include <set>
+
+typedef GENA::AccessTrace::ResId ResId;
+typedef GENA::AccessTrace::Record Record;
+
+SessionSummary summarize(const std::vector<Record>& records, const std::vector<GENA::ReplayAccess>& accesses)
+{
+	SessionSummary summary = {};
+
+	for (const Record& record : records)
+	{
+		switch (record.type)
+		{
+		case GENA::AccessTrace::Request:
+			++summary.requests;
+			break;
+
+		case GENA::AccessTrace::Preload:
+			++summary.preloads;
+			break;
+
+		case GENA::AccessTrace::Load:
+			++summary.loads;
+			summary.bytesLoaded += record.size;
+			break;
+
+		case GENA::AccessTrace::Evict:
+			++summary.evictions;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	if (!records.empty())
+	{
+		summary.durationSec = (records.back().timeUs - records.front().timeUs) / 1000000.0;
+	}
+
+	std::set<ResId> seen;
+	for (const GENA::ReplayAccess& access : accesses)
+	{
+		if (seen.insert(access.res).second)
+		{
+			summary.workingSet += access.size;
+		}
+	}
+	summary.numResources = seen.size();
+
+	return summary;
+}
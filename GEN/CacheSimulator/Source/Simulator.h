@@ -0,0 +1,24 @@
+#pragma once
+
+#include <AccessTrace.h>
+#include <CacheReplay.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * What a recorded session looked like to the cache that served it.
+ */
+struct SessionSummary
+{
+	double durationSec;
+	uint64_t requests;
+	uint64_t preloads;
+	uint64_t loads;
+	uint64_t evictions;
+	uint64_t bytesLoaded;
+	uint64_t numResources;
+	uint64_t workingSet;
+};
+
+SessionSummary summarize(const std::vector<GENA::AccessTrace::Record>& records, const std::vector<GENA::ReplayAccess>& accesses);
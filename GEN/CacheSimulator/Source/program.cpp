@@ -0,0 +1,136 @@
+#include "Simulator.h"
+
+#include <ArcEvictionPolicy.h>
+#include <LruEvictionPolicy.h>
+#include <TinyLfuEvictionPolicy.h>
+#include <TwoQueueEvictionPolicy.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+static const uint64_t mebi = 1024 * 1024;
+
+int main(int argc, char* argv[])
+try
+{
+	std::string usage = "Usage: ";
+	usage.append(argv[0]).append(" <trace file> [output file] [cache size in MiB]...\n"
+		"\n"
+		"Replays an access trace recorded by ResourceCache::startAccessTrace against\n"
+		"simulated caches of every eviction policy. Without sizes, caches from 1 MiB\n"
+		"doubling up to the working set of the trace are simulated. Results are\n"
+		"written as CSV to the output file, simulation.csv by default.\n");
+
+	if (argc < 2)
+	{
+		std::cerr << usage;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<GENA::AccessTrace::Record> records = GENA::AccessTrace::read(argv[1]);
+	std::vector<GENA::ReplayAccess> accesses = GENA::extractAccesses(records);
+	SessionSummary summary = summarize(records, accesses);
+
+	std::cout << "Session of " << summary.durationSec << " s: "
+		<< summary.requests << " requests, " << summary.preloads << " preloads, "
+		<< summary.loads << " loads (" << summary.bytesLoaded / mebi << " MiB), "
+		<< summary.evictions << " evictions\n"
+		<< summary.numResources << " resources used, working set " << summary.workingSet / mebi << " MiB\n";
+
+	if (accesses.empty())
+	{
+		std::cerr << "Nothing to replay\n";
+		return EXIT_FAILURE;
+	}
+
+	std::vector<uint64_t> sizesMiB;
+	for (int i = 3; i < argc; ++i)
+	{
+		sizesMiB.push_back(std::strtoull(argv[i], nullptr, 10));
+	}
+	if (sizesMiB.empty())
+	{
+		for (uint64_t size = 1; ; size *= 2)
+		{
+			sizesMiB.push_back(size);
+			if (size * mebi >= summary.workingSet)
+			{
+				break;
+			}
+		}
+	}
+
+	GENA::EvictionPolicyFactory factories[] =
+	{
+		&GENA::LruEvictionPolicy::create,
+		&GENA::TwoQueueEvictionPolicy::create,
+		&GENA::ArcEvictionPolicy::create,
+		&GENA::TinyLfuEvictionPolicy::create,
+	};
+
+	const std::string outputFile = argc > 2 ? argv[2] : "simulation.csv";
+	std::ofstream out(outputFile);
+	if (!out)
+	{
+		throw std::runtime_error("Failed to open " + outputFile + " for writing");
+	}
+	out << "Policy;CacheMiB;HitRate;PeakMiB;Evictions;BytesLoaded;BytesReloaded\n";
+
+	// The best hit rate seen and the smallest cache coming within a percent of it
+	double bestHitRate = 0.0;
+	std::vector<std::pair<double, std::pair<uint64_t, std::string>>> curve;
+
+	for (GENA::EvictionPolicyFactory factory : factories)
+	{
+		for (uint64_t sizeMiB : sizesMiB)
+		{
+			std::unique_ptr<GENA::IEvictionPolicy> policy = factory();
+			GENA::ReplayResult result = GENA::replayAccesses(accesses, *policy, sizeMiB * mebi);
+
+			double hitRate = (double)result.hits / (result.hits + result.misses);
+			bestHitRate = std::max(bestHitRate, hitRate);
+			curve.push_back(std::make_pair(hitRate, std::make_pair(sizeMiB, policy->getName())));
+
+			std::cout << policy->getName() << " " << sizeMiB << " MiB: hit rate " << hitRate
+				<< ", peak " << (double)result.peakBytes / mebi << " MiB"
+				<< ", reloaded " << result.bytesReloaded / mebi << " MiB\n";
+
+			out << policy->getName()
+				<< ';' << sizeMiB
+				<< ';' << hitRate
+				<< ';' << (double)result.peakBytes / mebi
+				<< ';' << result.evictions
+				<< ';' << result.bytesLoaded
+				<< ';' << result.bytesReloaded
+				<< '\n';
+		}
+	}
+
+	uint64_t smallestMiB = 0;
+	std::string smallestPolicy;
+	for (const auto& point : curve)
+	{
+		if (point.first >= bestHitRate - 0.01 && (smallestMiB == 0 || point.second.first < smallestMiB))
+		{
+			smallestMiB = point.second.first;
+			smallestPolicy = point.second.second;
+		}
+	}
+
+	std::cout << "Smallest cache within 1% of the best hit rate (" << bestHitRate << "): "
+		<< smallestMiB << " MiB with " << smallestPolicy << '\n';
+
+	return EXIT_SUCCESS;
+}
+catch (std::exception& ex)
+{
+	std::cerr << ex.what() << std::endl;
+	return EXIT_FAILURE;
+}
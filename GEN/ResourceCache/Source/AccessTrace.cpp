@@ -0,0 +1,124 @@
+#include "AccessTrace.h"
+
+#include <stdexcept>
+
+namespace GENA
+{
+	typedef std::chrono::high_resolution_clock cl;
+
+	struct TraceHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t recordSize;
+		uint32_t reserved;
+	};
+
+	static const char traceMagic[4] = { 'G', 'E', 'A', 'T' };
+	static const uint32_t traceVersion = 1;
+
+	AccessTrace::AccessTrace()
+		: recording(false)
+	{
+	}
+
+	AccessTrace::~AccessTrace()
+	{
+		close();
+	}
+
+	void AccessTrace::open(const std::string& path)
+	{
+		close();
+
+		std::lock_guard<std::mutex> guard(lock);
+
+		out.open(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			throw std::runtime_error("Failed to open " + path + " for writing");
+		}
+
+		TraceHeader header = { { traceMagic[0], traceMagic[1], traceMagic[2], traceMagic[3] }, traceVersion, sizeof(Record), 0 };
+		out.write((const char*)&header, sizeof(header));
+
+		pending.reserve(flushRecords);
+		startTime = cl::now();
+		recording = true;
+	}
+
+	void AccessTrace::close()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		if (!recording)
+		{
+			return;
+		}
+
+		recording = false;
+		flush();
+		out.close();
+	}
+
+	void AccessTrace::record(EventType type, ResId res, uint64_t size)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		// Checked again, the trace may have been closed since the caller looked
+		if (!recording)
+		{
+			return;
+		}
+
+		Record record;
+		record.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+		record.size = size;
+		record.res = res;
+		record.type = type;
+		pending.push_back(record);
+
+		if (pending.size() >= flushRecords)
+		{
+			flush();
+		}
+	}
+
+	void AccessTrace::flush()
+	{
+		if (!pending.empty())
+		{
+			out.write((const char*)pending.data(), pending.size() * sizeof(Record));
+			pending.clear();
+		}
+	}
+
+	std::vector<AccessTrace::Record> AccessTrace::read(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+		{
+			throw std::runtime_error("Failed to open " + path + " for reading");
+		}
+
+		TraceHeader header;
+		if (!in.read((char*)&header, sizeof(header)) ||
+			std::char_traits<char>::compare(header.magic, traceMagic, sizeof(traceMagic)) != 0)
+		{
+			throw std::runtime_error(path + " is not an access trace");
+		}
+		if (header.version != traceVersion || header.recordSize != sizeof(Record))
+		{
+			throw std::runtime_error(path + " is an access trace of an unsupported version");
+		}
+
+		std::vector<Record> records;
+		Record record;
+		while (in.read((char*)&record, sizeof(record)))
+		{
+			records.push_back(record);
+		}
+
+		return records;
+	}
+}
@@ -0,0 +1,120 @@
+#include "ArcEvictionPolicy.h"
+
+#include <algorithm>
+
+namespace GENA
+{
+	ArcEvictionPolicy::ArcEvictionPolicy()
+		: capacity(0),
+		targetT1(0)
+	{
+	}
+
+	std::unique_ptr<IEvictionPolicy> ArcEvictionPolicy::create()
+	{
+		return std::unique_ptr<IEvictionPolicy>(new ArcEvictionPolicy());
+	}
+
+	std::string ArcEvictionPolicy::getName() const
+	{
+		return "ARC";
+	}
+
+	void ArcEvictionPolicy::setCapacity(uint64_t bytes)
+	{
+		capacity = bytes;
+		targetT1 = std::min(targetT1, capacity);
+	}
+
+	void ArcEvictionPolicy::inserted(ResId res, uint64_t size)
+	{
+		removed(res);
+
+		if (b1.contains(res))
+		{
+			// Recency would have kept it, grow T1
+			uint64_t ratio = std::max<uint64_t>(1, b2.getBytes() / std::max<uint64_t>(1, b1.getBytes()));
+			targetT1 = std::min(capacity, targetT1 + ratio * size);
+
+			b1.remove(res);
+			t2.pushFront(res, size);
+		}
+		else if (b2.contains(res))
+		{
+			// Frequency would have kept it, shrink T1
+			uint64_t ratio = std::max<uint64_t>(1, b1.getBytes() / std::max<uint64_t>(1, b2.getBytes()));
+			uint64_t delta = ratio * size;
+			targetT1 = targetT1 > delta ? targetT1 - delta : 0;
+
+			b2.remove(res);
+			t2.pushFront(res, size);
+		}
+		else
+		{
+			t1.pushFront(res, size);
+		}
+
+		trimGhosts();
+	}
+
+	void ArcEvictionPolicy::accessed(ResId res)
+	{
+		if (t1.contains(res))
+		{
+			uint64_t size = t1.sizeOf(res);
+			t1.remove(res);
+			t2.pushFront(res, size);
+		}
+		else if (t2.contains(res))
+		{
+			t2.moveToFront(res);
+		}
+	}
+
+	void ArcEvictionPolicy::removed(ResId res)
+	{
+		if (!t1.remove(res))
+		{
+			t2.remove(res);
+		}
+	}
+
+	bool ArcEvictionPolicy::empty() const
+	{
+		return t1.empty() && t2.empty();
+	}
+
+	IEvictionPolicy::ResId ArcEvictionPolicy::selectVictim()
+	{
+		uint64_t size;
+
+		if (!t1.empty() && (t1.getBytes() > targetT1 || t2.empty()))
+		{
+			ResId victim = t1.popBack(size);
+			b1.pushFront(victim, size);
+			trimGhosts();
+			return victim;
+		}
+
+		ResId victim = t2.popBack(size);
+		b2.pushFront(victim, size);
+		trimGhosts();
+		return victim;
+	}
+
+	void ArcEvictionPolicy::trimGhosts()
+	{
+		uint64_t size;
+
+		// L1 = T1 + B1 may hold at most c bytes, L1 + L2 at most 2c
+		while (!b1.empty() && t1.getBytes() + b1.getBytes() > capacity)
+		{
+			b1.popBack(size);
+		}
+
+		while (!b2.empty() && t1.getBytes() + t2.getBytes() + b1.getBytes() + b2.getBytes() > 2 * capacity)
+		{
+			b2.popBack(size);
+		}
+	}
+}
@@ -0,0 +1,215 @@
+#include "CacheMetrics.h"
+
+#include "ThreadLocal.h"
+
+namespace GENA
+{
+	// Stripe of the calling thread plus one, 0 until it has counted something
+	static GENA_THREAD_LOCAL unsigned int threadStripe = 0;
+	static std::atomic<unsigned int> nextStripe(0);
+
+	static const char* const counterNames[CacheMetrics::NumCounters] =
+	{
+		"Hits",
+		"Resurrections",
+		"Misses",
+		"CoalescedWaits",
+		"Evictions",
+		"Loads",
+		"BytesLoaded",
+		"BytesDecompressed"
+	};
+
+	static const uint64_t otherTypeKey = ~0ull;
+
+	// Packed types are keys as is, apart from the two values slots reserve
+	static uint64_t typeKey(ResourceType type)
+	{
+		return type == 0 || type == otherTypeKey ? 1 : type;
+	}
+
+	static std::string typeName(uint64_t key)
+	{
+		return key == otherTypeKey ? "other" : unpackResourceType(key);
+	}
+
+	double CacheMetrics::TypeLatency::getPercentileMs(double fraction) const
+	{
+		const uint64_t wanted = (uint64_t)(loads * fraction + 0.5);
+
+		uint64_t seen = 0;
+		for (unsigned int i = 0; i < numLatencyBuckets; ++i)
+		{
+			seen += buckets[i];
+			if (seen >= wanted && seen > 0)
+			{
+				return i + 1 < numLatencyBuckets ? (1ull << i) / 1000.0 : maxMs;
+			}
+		}
+
+		return maxMs;
+	}
+
+	CacheMetrics::CacheMetrics()
+	{
+		for (auto& slot : types)
+		{
+			slot.key = 0;
+		}
+		reset();
+	}
+
+	void CacheMetrics::add(Counter counter, uint64_t amount)
+	{
+		if (threadStripe == 0)
+		{
+			threadStripe = nextStripe++ % numStripes + 1;
+		}
+
+		stripes[threadStripe - 1].counters[counter].fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	void CacheMetrics::recordLatency(ResourceType type, uint64_t latencyUs)
+	{
+		const uint64_t key = typeKey(type);
+
+		// Slots are claimed once and never given back, so a key found stays put
+		TypeSlot* slot = &types[maxTypes];
+		for (unsigned int i = 0; i < maxTypes; ++i)
+		{
+			uint64_t current = types[i].key.load(std::memory_order_acquire);
+			if (current == 0)
+			{
+				if (types[i].key.compare_exchange_strong(current, key) || current == key)
+				{
+					slot = &types[i];
+					break;
+				}
+			}
+			else if (current == key)
+			{
+				slot = &types[i];
+				break;
+			}
+		}
+
+		unsigned int bucket = 0;
+		while (bucket + 1 < numLatencyBuckets && latencyUs >= (1ull << bucket))
+		{
+			++bucket;
+		}
+
+		slot->loads.fetch_add(1, std::memory_order_relaxed);
+		slot->totalUs.fetch_add(latencyUs, std::memory_order_relaxed);
+		slot->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+		uint64_t prevMax = slot->maxUs.load(std::memory_order_relaxed);
+		while (latencyUs > prevMax && !slot->maxUs.compare_exchange_weak(prevMax, latencyUs))
+		{
+		}
+	}
+
+	CacheMetrics::Snapshot CacheMetrics::getSnapshot() const
+	{
+		Snapshot snapshot;
+
+		for (unsigned int counter = 0; counter < NumCounters; ++counter)
+		{
+			snapshot.counters[counter] = 0;
+			for (unsigned int stripe = 0; stripe < numStripes; ++stripe)
+			{
+				snapshot.counters[counter] += stripes[stripe].counters[counter].load(std::memory_order_relaxed);
+			}
+		}
+
+		const uint64_t requests = snapshot.counters[Hits] + snapshot.counters[Misses];
+		snapshot.hitRate = requests > 0 ? (double)snapshot.counters[Hits] / requests : 0.0;
+
+		for (unsigned int i = 0; i <= maxTypes; ++i)
+		{
+			const TypeSlot& slot = types[i];
+
+			TypeLatency latency;
+			latency.loads = slot.loads.load(std::memory_order_relaxed);
+			if (latency.loads == 0)
+			{
+				continue;
+			}
+
+			latency.type = typeName(i < maxTypes ? slot.key.load() : otherTypeKey);
+			latency.avgMs = slot.totalUs.load(std::memory_order_relaxed) / 1000.0 / latency.loads;
+			latency.maxMs = slot.maxUs.load(std::memory_order_relaxed) / 1000.0;
+			for (unsigned int bucket = 0; bucket < numLatencyBuckets; ++bucket)
+			{
+				latency.buckets[bucket] = slot.buckets[bucket].load(std::memory_order_relaxed);
+			}
+
+			snapshot.latencies.push_back(latency);
+		}
+
+		return snapshot;
+	}
+
+	void CacheMetrics::reset()
+	{
+		for (auto& stripe : stripes)
+		{
+			for (auto& counter : stripe.counters)
+			{
+				counter = 0;
+			}
+		}
+
+		// Keys stay, a type keeps its slot for the life of the metrics
+		for (auto& slot : types)
+		{
+			slot.loads = 0;
+			slot.totalUs = 0;
+			slot.maxUs = 0;
+			for (auto& bucket : slot.buckets)
+			{
+				bucket = 0;
+			}
+		}
+	}
+
+	const char* CacheMetrics::getCounterName(Counter counter)
+	{
+		return counter < NumCounters ? counterNames[counter] : "Unknown";
+	}
+
+	void CacheMetrics::writeCounterHeader(std::ostream& out)
+	{
+		for (unsigned int counter = 0; counter < NumCounters; ++counter)
+		{
+			out << counterNames[counter] << ';';
+		}
+		out << "HitRate\n";
+	}
+
+	void CacheMetrics::writeCounterRow(std::ostream& out, const Snapshot& snapshot)
+	{
+		for (unsigned int counter = 0; counter < NumCounters; ++counter)
+		{
+			out << snapshot.counters[counter] << ';';
+		}
+		out << snapshot.hitRate << '\n';
+	}
+
+	void CacheMetrics::writeLatencyCsv(std::ostream& out, const Snapshot& snapshot)
+	{
+		out << "Type;Loads;AvgMs;P50Ms;P90Ms;P99Ms;MaxMs\n";
+
+		for (const TypeLatency& latency : snapshot.latencies)
+		{
+			out << latency.type
+				<< ';' << latency.loads
+				<< ';' << latency.avgMs
+				<< ';' << latency.getPercentileMs(0.5)
+				<< ';' << latency.getPercentileMs(0.9)
+				<< ';' << latency.getPercentileMs(0.99)
+				<< ';' << latency.maxMs
+				<< '\n';
+		}
+	}
+}
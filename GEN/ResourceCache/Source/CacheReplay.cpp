@@ -0,0 +1,80 @@
+#include "CacheReplay.h"
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+
+namespace GENA
+{
+	std::vector<ReplayAccess> extractAccesses(const std::vector<AccessTrace::Record>& records)
+	{
+		std::unordered_map<AccessTrace::ResId, uint64_t> sizes;
+		for (const AccessTrace::Record& record : records)
+		{
+			uint64_t& size = sizes[record.res];
+			size = std::max(size, record.size);
+		}
+
+		std::vector<ReplayAccess> accesses;
+		for (const AccessTrace::Record& record : records)
+		{
+			if (record.type == AccessTrace::Request || record.type == AccessTrace::Preload)
+			{
+				ReplayAccess access = { record.res, sizes[record.res] };
+				accesses.push_back(access);
+			}
+		}
+
+		return accesses;
+	}
+
+	ReplayResult replayAccesses(const std::vector<ReplayAccess>& accesses, IEvictionPolicy& policy, uint64_t capacity)
+	{
+		typedef IEvictionPolicy::ResId ResId;
+
+		ReplayResult result = {};
+
+		std::unordered_map<ResId, uint64_t> resident;
+		std::set<ResId> loadedBefore;
+		uint64_t used = 0;
+
+		policy.setCapacity(capacity);
+
+		for (const ReplayAccess& access : accesses)
+		{
+			if (resident.count(access.res) != 0)
+			{
+				policy.accessed(access.res);
+				++result.hits;
+				continue;
+			}
+
+			++result.misses;
+			result.bytesLoaded += access.size;
+			if (!loadedBefore.insert(access.res).second)
+			{
+				result.bytesReloaded += access.size;
+			}
+
+			if (access.size > capacity)
+			{
+				continue;
+			}
+
+			while (used + access.size > capacity && !policy.empty())
+			{
+				ResId victim = policy.selectVictim();
+				used -= resident[victim];
+				resident.erase(victim);
+				++result.evictions;
+			}
+
+			policy.inserted(access.res, access.size);
+			resident[access.res] = access.size;
+			used += access.size;
+			result.peakBytes = std::max(result.peakBytes, used);
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,163 @@
+#include "CompressedStore.h"
+
+#include <zlib.h>
+#if defined( NDEBUG ) || ! defined( _DEBUG )
+#pragma comment(lib, "zlibstatic")
+#else
+#pragma comment(lib, "zlibstaticd")
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace GENA
+{
+	CompressedStore::CompressedStore(uint64_t budget)
+		: budget(budget),
+		rawBytes(0),
+		numStored(0),
+		numRejected(0),
+		numEvicted(0)
+	{
+	}
+
+	void CompressedStore::setBudget(uint64_t bytes)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		budget = bytes;
+		while (order.getBytes() > budget)
+		{
+			erase(order.back());
+			++numEvicted;
+		}
+	}
+
+	uint64_t CompressedStore::getBudget() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return budget;
+	}
+
+	void CompressedStore::store(ResId res, const char* data, uint64_t size)
+	{
+		uLongf compSize = compressBound((uLong)size);
+		Buffer compressed((size_t)compSize);
+
+		// Favour speed, this runs whenever a resource leaves memory
+		if (compress2((Bytef*)compressed.data(), &compSize, (const Bytef*)data, (uLong)size, Z_BEST_SPEED) != Z_OK
+			|| compSize >= size)
+		{
+			++numRejected;
+			return;
+		}
+
+		// Trim the buffer down to what the data actually needs
+		Buffer trimmed((size_t)compSize);
+		std::copy(compressed.data(), compressed.data() + compSize, trimmed.data());
+		compressed.clear();
+
+		std::lock_guard<std::mutex> guard(lock);
+
+		erase(res);
+
+		if (compSize > budget)
+		{
+			++numRejected;
+			return;
+		}
+
+		while (order.getBytes() + compSize > budget)
+		{
+			erase(order.back());
+			++numEvicted;
+		}
+
+		Entry& entry = entries[res];
+		entry.data = std::move(trimmed);
+		entry.rawSize = size;
+		order.pushFront(res, compSize);
+		rawBytes += size;
+		++numStored;
+	}
+
+	uint64_t CompressedStore::getRawSize(ResId res) const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		auto iter = entries.find(res);
+		return iter != entries.end() ? iter->second.rawSize : 0;
+	}
+
+	bool CompressedStore::take(ResId res, char* buffer, uint64_t size)
+	{
+		Entry entry;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			auto iter = entries.find(res);
+			if (iter == entries.end())
+			{
+				return false;
+			}
+
+			entry.data = std::move(iter->second.data);
+			entry.rawSize = iter->second.rawSize;
+			erase(res);
+		}
+
+		uLongf destLen = (uLongf)size;
+		if (entry.rawSize != size
+			|| uncompress((Bytef*)buffer, &destLen, (const Bytef*)entry.data.data(), (uLong)entry.data.size()) != Z_OK
+			|| destLen != size)
+		{
+			throw std::runtime_error("Compressed copy of resource is corrupt");
+		}
+
+		return true;
+	}
+
+	void CompressedStore::remove(ResId res)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		erase(res);
+	}
+
+	void CompressedStore::clear()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		while (!order.empty())
+		{
+			erase(order.back());
+		}
+	}
+
+	CompressedStore::Stats CompressedStore::getStats() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		Stats stats;
+		stats.stored = numStored;
+		stats.rejected = numRejected;
+		stats.evicted = numEvicted;
+		stats.numResources = entries.size();
+		stats.compressedBytes = order.getBytes();
+		stats.rawBytes = rawBytes;
+
+		return stats;
+	}
+
+	void CompressedStore::erase(ResId res)
+	{
+		auto iter = entries.find(res);
+		if (iter == entries.end())
+		{
+			return;
+		}
+
+		rawBytes -= iter->second.rawSize;
+		order.remove(res);
+		entries.erase(iter);
+	}
+}
@@ -0,0 +1,152 @@
+#include "DecodedDiskCache.h"
+
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace GENA
+{
+	static const char fileMagic[4] = { 'G', 'E', 'D', 'C' };
+
+	DecodedDiskCache::DecodedDiskCache()
+		: numHits(0),
+		numMisses(0),
+		numStale(0),
+		numStores(0),
+		numFailedStores(0)
+	{
+	}
+
+	void DecodedDiskCache::setDirectory(const std::string& path)
+	{
+		directory = path;
+
+		if (!directory.empty())
+		{
+			// Fails harmlessly if the directory is already there
+#ifdef _WIN32
+			_mkdir(directory.c_str());
+#else
+			mkdir(directory.c_str(), 0755);
+#endif
+		}
+	}
+
+	bool DecodedDiskCache::isEnabled() const
+	{
+		return !directory.empty();
+	}
+
+	bool DecodedDiskCache::find(ResId res, uint32_t checksum, uint32_t version, IResourceFile::MappedView& view)
+	{
+		std::shared_ptr<MappedFile> mapping;
+		try
+		{
+			mapping = std::make_shared<MappedFile>(getPath(res));
+		}
+		catch (std::exception&)
+		{
+			++numMisses;
+			return false;
+		}
+
+		FileHeader header;
+		if (mapping->size() < sizeof(header))
+		{
+			++numStale;
+			return false;
+		}
+		memcpy(&header, mapping->data(), sizeof(header));
+
+		if (memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0
+			|| header.checksum != checksum
+			|| header.version != version
+			|| header.res != res
+			|| header.size != mapping->size() - sizeof(header))
+		{
+			// Built from an older archive or loader, overwritten on the next store
+			++numStale;
+			return false;
+		}
+
+		view.data = mapping->data() + sizeof(header);
+		view.size = header.size;
+		view.mapping = mapping;
+
+		++numHits;
+		return true;
+	}
+
+	void DecodedDiskCache::store(ResId res, uint32_t checksum, uint32_t version, const char* data, uint64_t size)
+	{
+		FileHeader header;
+		memcpy(header.magic, fileMagic, sizeof(fileMagic));
+		header.checksum = checksum;
+		header.version = version;
+		header.res = res;
+		header.size = size;
+
+		const std::string path = getPath(res);
+
+		// Unique per thread in case two loads of res finish together
+		std::ostringstream tempName;
+		tempName << path << '.' << std::this_thread::get_id() << ".tmp";
+		const std::string tempPath = tempName.str();
+
+		{
+			std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+			out.write((const char*)&header, sizeof(header));
+			out.write(data, (std::streamsize)size);
+
+			if (!out)
+			{
+				out.close();
+				std::remove(tempPath.c_str());
+				++numFailedStores;
+				return;
+			}
+		}
+
+		// Written in full before it replaces the old file, so a crash never
+		// leaves a half written file behind under the real name
+		std::remove(path.c_str());
+		if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+		{
+			std::remove(tempPath.c_str());
+			++numFailedStores;
+			return;
+		}
+
+		++numStores;
+	}
+
+	DecodedDiskCache::Stats DecodedDiskCache::getStats() const
+	{
+		Stats stats;
+		stats.hits = numHits;
+		stats.misses = numMisses;
+		stats.stale = numStale;
+		stats.stores = numStores;
+		stats.failedStores = numFailedStores;
+
+		return stats;
+	}
+
+	std::string DecodedDiskCache::getPath(ResId res) const
+	{
+		std::ostringstream path;
+		path << directory << '/' << std::hex << std::setw(8) << std::setfill('0') << res << ".dec";
+		return path.str();
+	}
+}
@@ -0,0 +1,217 @@
+#include "FileWatcher.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace GENA
+{
+	// How long a file has to be left alone before a change is reported
+	static const int settleMs = 100;
+
+	// directory keeps its trailing separator, directory + filename is the file again
+	static void splitPath(const std::string& filepath, std::string& directory, std::string& filename)
+	{
+		size_t lastSlash = filepath.find_last_of("/\\");
+		if (lastSlash == std::string::npos)
+		{
+			directory = "./";
+			filename = filepath;
+		}
+		else
+		{
+			directory = filepath.substr(0, lastSlash + 1);
+			filename = filepath.substr(lastSlash + 1);
+		}
+	}
+
+#ifdef _WIN32
+	static bool getWriteTime(const std::string& filepath, FILETIME& writeTime)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(filepath.c_str(), GetFileExInfoStandard, &attributes))
+		{
+			return false;
+		}
+
+		writeTime = attributes.ftLastWriteTime;
+		return true;
+	}
+
+	FileWatcher::FileWatcher(const std::string& filepath, ChangeCallback callback, void* userData)
+		: callback(callback),
+		userData(userData),
+		changeHandle(INVALID_HANDLE_VALUE),
+		stopEvent(nullptr)
+	{
+		splitPath(filepath, directory, filename);
+
+		changeHandle = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE);
+		if (changeHandle == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error(directory + " could not be watched");
+		}
+
+		stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+		if (stopEvent == nullptr)
+		{
+			FindCloseChangeNotification(changeHandle);
+			throw std::runtime_error("Failed to create the watcher stop event");
+		}
+
+		watcher = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		SetEvent(stopEvent);
+		watcher.join();
+
+		CloseHandle(stopEvent);
+		FindCloseChangeNotification(changeHandle);
+	}
+
+	void FileWatcher::run()
+	{
+		const std::string filepath = directory + filename;
+
+		// The directory tells that something in it changed, the write time which file
+		FILETIME lastWrite = {};
+		getWriteTime(filepath, lastWrite);
+
+		HANDLE handles[] = { stopEvent, changeHandle };
+		while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1)
+		{
+			FindNextChangeNotification(changeHandle);
+
+			FILETIME writeTime;
+			if (!getWriteTime(filepath, writeTime) || CompareFileTime(&writeTime, &lastWrite) == 0)
+			{
+				continue;
+			}
+
+			// Wait out the rest of the burst
+			while (WaitForMultipleObjects(2, handles, FALSE, settleMs) == WAIT_OBJECT_0 + 1)
+			{
+				FindNextChangeNotification(changeHandle);
+			}
+			if (WaitForSingleObject(stopEvent, 0) == WAIT_OBJECT_0)
+			{
+				break;
+			}
+
+			getWriteTime(filepath, lastWrite);
+			callback(userData);
+		}
+	}
+#else
+	FileWatcher::FileWatcher(const std::string& filepath, ChangeCallback callback, void* userData)
+		: callback(callback),
+		userData(userData),
+		notifyDesc(-1)
+	{
+		splitPath(filepath, directory, filename);
+
+		notifyDesc = inotify_init();
+		if (notifyDesc < 0)
+		{
+			throw std::runtime_error("Failed to initialize inotify");
+		}
+
+		// Written in place or renamed over, either way the file is done with
+		if (inotify_add_watch(notifyDesc, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			::close(notifyDesc);
+			throw std::runtime_error(directory + " could not be watched");
+		}
+
+		if (pipe(stopPipe) != 0)
+		{
+			::close(notifyDesc);
+			throw std::runtime_error("Failed to create the watcher stop pipe");
+		}
+
+		watcher = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		char stop = 0;
+		if (write(stopPipe[1], &stop, 1) != 1)
+		{
+			// Nothing left to wake the watcher, it would never be joined
+			std::terminate();
+		}
+		watcher.join();
+
+		::close(stopPipe[0]);
+		::close(stopPipe[1]);
+		::close(notifyDesc);
+	}
+
+	void FileWatcher::run()
+	{
+		pollfd fds[2];
+		fds[0].fd = stopPipe[0];
+		fds[0].events = POLLIN;
+		fds[1].fd = notifyDesc;
+		fds[1].events = POLLIN;
+
+		alignas(inotify_event) char events[4096];
+
+		int timeoutMs = -1;
+		bool changed = false;
+
+		while (true)
+		{
+			fds[0].revents = 0;
+			fds[1].revents = 0;
+
+			int ready = poll(fds, 2, timeoutMs);
+			if (fds[0].revents != 0)
+			{
+				break;
+			}
+
+			if (ready == 0)
+			{
+				// The burst is over
+				timeoutMs = -1;
+				changed = false;
+				callback(userData);
+				continue;
+			}
+
+			if (ready < 0 || (fds[1].revents & POLLIN) == 0)
+			{
+				continue;
+			}
+
+			ssize_t length = read(notifyDesc, events, sizeof(events));
+			for (ssize_t pos = 0; pos < length; )
+			{
+				const inotify_event* event = (const inotify_event*)(events + pos);
+				if (event->len > 0 && filename == event->name)
+				{
+					changed = true;
+				}
+				pos += sizeof(inotify_event) + event->len;
+			}
+
+			if (changed)
+			{
+				timeoutMs = settleMs;
+			}
+		}
+	}
+#endif
+}
@@ -0,0 +1,59 @@
+#include "LruEvictionPolicy.h"
+
+namespace GENA
+{
+	std::unique_ptr<IEvictionPolicy> LruEvictionPolicy::create()
+	{
+		return std::unique_ptr<IEvictionPolicy>(new LruEvictionPolicy());
+	}
+
+	std::string LruEvictionPolicy::getName() const
+	{
+		return "LRU";
+	}
+
+	void LruEvictionPolicy::setCapacity(uint64_t)
+	{
+	}
+
+	void LruEvictionPolicy::inserted(ResId res, uint64_t)
+	{
+		removed(res);
+
+		order.push_front(res);
+		positions[res] = order.begin();
+	}
+
+	void LruEvictionPolicy::accessed(ResId res)
+	{
+		auto iter = positions.find(res);
+		if (iter != positions.end())
+		{
+			order.splice(order.begin(), order, iter->second);
+		}
+	}
+
+	void LruEvictionPolicy::removed(ResId res)
+	{
+		auto iter = positions.find(res);
+		if (iter != positions.end())
+		{
+			order.erase(iter->second);
+			positions.erase(iter);
+		}
+	}
+
+	bool LruEvictionPolicy::empty() const
+	{
+		return order.empty();
+	}
+
+	IEvictionPolicy::ResId LruEvictionPolicy::selectVictim()
+	{
+		ResId victim = order.back();
+		order.pop_back();
+		positions.erase(victim);
+
+		return victim;
+	}
+}
@@ -0,0 +1,148 @@
+#include "MappedFile.h"
+#include "PositionalFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace GENA
+{
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& filepath)
+		: fileHandle(INVALID_HANDLE_VALUE),
+		mappingHandle(nullptr),
+		mapData(nullptr),
+		mapSize(0)
+	{
+		// Sharing delete lets the packer rename a new archive over this one
+		fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error(filepath + " could not be opened for mapping");
+		}
+
+		mapOpenFile(filepath);
+	}
+
+	MappedFile::MappedFile(const PositionalFile& file)
+		: fileHandle(INVALID_HANDLE_VALUE),
+		mappingHandle(nullptr),
+		mapData(nullptr),
+		mapSize(0)
+	{
+		HANDLE process = GetCurrentProcess();
+		if (!DuplicateHandle(process, file.fileHandle, process, &fileHandle, 0, FALSE, DUPLICATE_SAME_ACCESS))
+		{
+			throw std::runtime_error("File could not be opened for mapping");
+		}
+
+		mapOpenFile("File");
+	}
+
+	void MappedFile::mapOpenFile(const std::string& name)
+	{
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize))
+		{
+			CloseHandle(fileHandle);
+			throw std::runtime_error(name + " has no size");
+		}
+		mapSize = fileSize.QuadPart;
+
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle == nullptr)
+		{
+			CloseHandle(fileHandle);
+			throw std::runtime_error(name + " could not be mapped");
+		}
+
+		mapData = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (mapData == nullptr)
+		{
+			CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+			throw std::runtime_error(name + " could not be mapped");
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		UnmapViewOfFile(mapData);
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+	}
+#else
+	MappedFile::MappedFile(const std::string& filepath)
+		: fileDesc(-1),
+		mapData(nullptr),
+		mapSize(0)
+	{
+		fileDesc = ::open(filepath.c_str(), O_RDONLY);
+		if (fileDesc < 0)
+		{
+			throw std::runtime_error(filepath + " could not be opened for mapping");
+		}
+
+		mapOpenFile(filepath);
+	}
+
+	MappedFile::MappedFile(const PositionalFile& file)
+		: fileDesc(-1),
+		mapData(nullptr),
+		mapSize(0)
+	{
+		fileDesc = dup(file.fileDesc);
+		if (fileDesc < 0)
+		{
+			throw std::runtime_error("File could not be opened for mapping");
+		}
+
+		mapOpenFile("File");
+	}
+
+	void MappedFile::mapOpenFile(const std::string& name)
+	{
+		struct stat fileStat;
+		if (fstat(fileDesc, &fileStat) != 0)
+		{
+			::close(fileDesc);
+			throw std::runtime_error(name + " has no size");
+		}
+		mapSize = fileStat.st_size;
+
+		void* mapped = mmap(nullptr, (size_t)mapSize, PROT_READ, MAP_SHARED, fileDesc, 0);
+		if (mapped == MAP_FAILED)
+		{
+			::close(fileDesc);
+			throw std::runtime_error(name + " could not be mapped");
+		}
+		mapData = (const char*)mapped;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		munmap((void*)mapData, (size_t)mapSize);
+		::close(fileDesc);
+	}
+#endif
+
+	const char* MappedFile::data() const
+	{
+		return mapData;
+	}
+
+	uint64_t MappedFile::size() const
+	{
+		return mapSize;
+	}
+}
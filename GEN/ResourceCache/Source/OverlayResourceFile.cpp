@@ -0,0 +1,235 @@
+#include "OverlayResourceFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace GENA
+{
+	OverlayResourceFile::OverlayResourceFile()
+	{
+	}
+
+	std::shared_ptr<const OverlayResourceFile::Merged> OverlayResourceFile::merge() const
+	{
+		std::shared_ptr<Merged> newMerged(std::make_shared<Merged>());
+
+		for (const Mount& mount : mounts)
+		{
+			const uint32_t numRes = mount.file->getNumResources();
+			for (uint32_t i = 0; i < numRes; ++i)
+			{
+				const ResId res = mount.file->getResourceId(i);
+
+				// Taken by a file of higher priority if already there
+				if (newMerged->owners.insert(std::make_pair(res, mount.file.get())).second)
+				{
+					newMerged->ids.push_back(res);
+				}
+			}
+		}
+
+		return newMerged;
+	}
+
+	std::shared_ptr<const OverlayResourceFile::Merged> OverlayResourceFile::getMerged() const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return merged;
+	}
+
+	IResourceFile& OverlayResourceFile::getOwner(ResId res) const
+	{
+		std::shared_ptr<const Merged> current = getMerged();
+
+		auto iter = current->owners.find(res);
+		if (iter == current->owners.end())
+		{
+			throw std::runtime_error("Resource is not in any mounted file");
+		}
+
+		// Files are never unmounted, so the owner outlives the index
+		return *iter->second;
+	}
+
+	void OverlayResourceFile::mount(std::unique_ptr<IResourceFile>&& file, int priority)
+	{
+		if (merged)
+		{
+			throw std::runtime_error("Files can not be mounted once opened");
+		}
+
+		auto pos = std::find_if(mounts.begin(), mounts.end(),
+			[priority](const Mount& mount) { return mount.priority <= priority; });
+
+		Mount newMount;
+		newMount.file = std::move(file);
+		newMount.priority = priority;
+		mounts.insert(pos, newMount);
+	}
+
+	size_t OverlayResourceFile::getNumMounts() const
+	{
+		return mounts.size();
+	}
+
+	void OverlayResourceFile::open()
+	{
+		for (Mount& mount : mounts)
+		{
+			mount.file->open();
+		}
+
+		std::shared_ptr<const Merged> newMerged = merge();
+		{
+			std::lock_guard<std::mutex> lock(reloadLock);
+			merged = newMerged;
+		}
+
+		names.build(*this, [&newMerged](ResId res) { return newMerged->owners.at(res)->getResourceName(res); });
+	}
+
+	uint64_t OverlayResourceFile::getRawResourceSize(ResId res)
+	{
+		return getOwner(res).getRawResourceSize(res);
+	}
+
+	void OverlayResourceFile::getRawResource(ResId res, char* buffer)
+	{
+		getOwner(res).getRawResource(res, buffer);
+	}
+
+	uint32_t OverlayResourceFile::getNumResources() const
+	{
+		return getMerged()->ids.size();
+	}
+
+	IResourceFile::ResId OverlayResourceFile::getResourceId(uint32_t num) const
+	{
+		return getMerged()->ids[num];
+	}
+
+	const std::string& OverlayResourceFile::getResourceName(ResId res) const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return names.getName(res);
+	}
+
+	bool OverlayResourceFile::findResource(const std::string& name, ResId& res) const
+	{
+		std::lock_guard<std::mutex> lock(reloadLock);
+		return names.find(name, res);
+	}
+
+	std::string OverlayResourceFile::getResourceType(ResId res) const
+	{
+		return getOwner(res).getResourceType(res);
+	}
+
+	ResourceType OverlayResourceFile::getResourceTypeCode(ResId res) const
+	{
+		return getOwner(res).getResourceTypeCode(res);
+	}
+
+	std::vector<IResourceFile::ResId> OverlayResourceFile::getResourceDependencies(ResId res) const
+	{
+		return getOwner(res).getResourceDependencies(res);
+	}
+
+	uint32_t OverlayResourceFile::getResourceChecksum(ResId res) const
+	{
+		return getOwner(res).getResourceChecksum(res);
+	}
+
+	bool OverlayResourceFile::mapRawResource(ResId res, MappedView& view)
+	{
+		return getOwner(res).mapRawResource(res, view);
+	}
+
+	uint64_t OverlayResourceFile::getStoredResourceSize(ResId res)
+	{
+		return getOwner(res).getStoredResourceSize(res);
+	}
+
+	void OverlayResourceFile::getStoredResource(ResId res, char* buffer)
+	{
+		getOwner(res).getStoredResource(res, buffer);
+	}
+
+	bool OverlayResourceFile::needsDecode(ResId res) const
+	{
+		return getOwner(res).needsDecode(res);
+	}
+
+	void OverlayResourceFile::decodeResource(ResId res, const char* stored, uint64_t storedSize, char* buffer)
+	{
+		getOwner(res).decodeResource(res, stored, storedSize, buffer);
+	}
+
+	bool OverlayResourceFile::reload(std::vector<ResId>& changed)
+	{
+		std::map<const IResourceFile*, std::vector<ResId>> fileChanges;
+		std::vector<ResId> candidates;
+		bool reloaded = false;
+
+		for (Mount& mount : mounts)
+		{
+			std::vector<ResId>& changes = fileChanges[mount.file.get()];
+			if (mount.file->reload(changes))
+			{
+				reloaded = true;
+				std::sort(changes.begin(), changes.end());
+				candidates.insert(candidates.end(), changes.begin(), changes.end());
+			}
+		}
+
+		if (!reloaded)
+		{
+			return false;
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+		std::shared_ptr<const Merged> oldMerged = getMerged();
+		std::shared_ptr<const Merged> newMerged = merge();
+
+		const size_t firstChanged = changed.size();
+		for (ResId res : candidates)
+		{
+			auto oldIter = oldMerged->owners.find(res);
+			auto newIter = newMerged->owners.find(res);
+			const IResourceFile* oldOwner = oldIter != oldMerged->owners.end() ? oldIter->second : nullptr;
+			const IResourceFile* newOwner = newIter != newMerged->owners.end() ? newIter->second : nullptr;
+
+			if (oldOwner != newOwner
+				|| (newOwner && std::binary_search(fileChanges[newOwner].begin(), fileChanges[newOwner].end(), res)))
+			{
+				changed.push_back(res);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(reloadLock);
+
+		// Removed first, a name may have moved on to a new resource
+		for (size_t i = firstChanged; i < changed.size(); ++i)
+		{
+			if (newMerged->owners.count(changed[i]) == 0)
+			{
+				names.remove(changed[i]);
+			}
+		}
+
+		for (size_t i = firstChanged; i < changed.size(); ++i)
+		{
+			auto iter = newMerged->owners.find(changed[i]);
+			if (iter != newMerged->owners.end())
+			{
+				names.set(changed[i], iter->second->getResourceName(changed[i]));
+			}
+		}
+
+		merged = newMerged;
+
+		return true;
+	}
+}
@@ -0,0 +1,163 @@
+#include "PositionalFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace GENA
+{
+#ifdef _WIN32
+	PositionalFile::PositionalFile(const std::string& filepath)
+		: fileHandle(INVALID_HANDLE_VALUE),
+		fileSize(0)
+	{
+		// Synchronous handles have their reads serialized by the system,
+		// overlapped ones read in parallel
+		fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error(filepath + " could not be opened");
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(fileHandle, &size))
+		{
+			CloseHandle(fileHandle);
+			throw std::runtime_error(filepath + " has no size");
+		}
+		fileSize = size.QuadPart;
+	}
+
+	PositionalFile::~PositionalFile()
+	{
+		CloseHandle(fileHandle);
+	}
+
+	void PositionalFile::read(uint64_t offset, char* buffer, uint64_t size) const
+	{
+		if (offset + size > fileSize)
+		{
+			throw std::runtime_error("Read past the end of the file");
+		}
+
+		// Every read waits on an event of its own, the handle is shared
+		HANDLE done = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+		if (done == nullptr)
+		{
+			throw std::runtime_error("Failed to create a read event");
+		}
+
+		while (size > 0)
+		{
+			OVERLAPPED overlapped = {};
+			overlapped.Offset = (DWORD)offset;
+			overlapped.OffsetHigh = (DWORD)(offset >> 32);
+			overlapped.hEvent = done;
+
+			const DWORD chunk = (DWORD)std::min<uint64_t>(size, 1u << 30);
+			DWORD bytesRead = 0;
+			if ((!ReadFile(fileHandle, buffer, chunk, nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+				|| !GetOverlappedResult(fileHandle, &overlapped, &bytesRead, TRUE)
+				|| bytesRead == 0)
+			{
+				CloseHandle(done);
+				throw std::runtime_error("Failed to read from the file");
+			}
+
+			buffer += bytesRead;
+			offset += bytesRead;
+			size -= bytesRead;
+		}
+
+		CloseHandle(done);
+	}
+#else
+	PositionalFile::PositionalFile(const std::string& filepath)
+		: fileDesc(-1),
+		fileSize(0)
+	{
+		fileDesc = ::open(filepath.c_str(), O_RDONLY);
+		if (fileDesc < 0)
+		{
+			throw std::runtime_error(filepath + " could not be opened");
+		}
+
+		struct stat fileStat;
+		if (fstat(fileDesc, &fileStat) != 0)
+		{
+			::close(fileDesc);
+			throw std::runtime_error(filepath + " has no size");
+		}
+		fileSize = fileStat.st_size;
+	}
+
+	PositionalFile::~PositionalFile()
+	{
+		::close(fileDesc);
+	}
+
+	void PositionalFile::read(uint64_t offset, char* buffer, uint64_t size) const
+	{
+		if (offset + size > fileSize)
+		{
+			throw std::runtime_error("Read past the end of the file");
+		}
+
+		while (size > 0)
+		{
+			// Reads may come back short, the rest is asked for again
+			ssize_t bytesRead = pread(fileDesc, buffer, (size_t)size, (off_t)offset);
+			if (bytesRead < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (bytesRead <= 0)
+			{
+				throw std::runtime_error("Failed to read from the file");
+			}
+
+			buffer += bytesRead;
+			offset += bytesRead;
+			size -= bytesRead;
+		}
+	}
+#endif
+
+	uint64_t PositionalFile::size() const
+	{
+		return fileSize;
+	}
+
+	PositionalStreamBuf::PositionalStreamBuf(const PositionalFile& file)
+		: file(file),
+		nextOffset(0),
+		buffer(64 * 1024)
+	{
+	}
+
+	PositionalStreamBuf::int_type PositionalStreamBuf::underflow()
+	{
+		if (nextOffset >= file.size())
+		{
+			return traits_type::eof();
+		}
+
+		const size_t chunk = (size_t)std::min<uint64_t>(buffer.size(), file.size() - nextOffset);
+		file.read(nextOffset, buffer.data(), chunk);
+		nextOffset += chunk;
+
+		setg(buffer.data(), buffer.data(), buffer.data() + chunk);
+		return traits_type::to_int_type(buffer[0]);
+	}
+}
@@ -1,366 +1,2248 @@
 #include "ResourceCache.h"
 
 #include "DefaultResourceLoader.h"
+#include "LruEvictionPolicy.h"
+#include "Trace.h"
 
 #include <algorithm>
-#include <iomanip>
-#include <iostream>
+#include <chrono>
+#include <set>
+#include <sstream>
 
 namespace GENA
 {
+	// Number of allocations between two budget rebalances in sharded mode
+	static const uint32_t rebalanceInterval = 64;
+
+	typedef std::chrono::high_resolution_clock cl;
+
+	ResourceCache::Shard::Shard()
+		: budget(0),
+		allocated(0),
+		pendingFree(0),
+		demand(0)
+	{
+	}
+
+	uint64_t ResourceCache::Shard::liveBytes() const
+	{
+		const uint64_t pending = pendingFree;
+		const uint64_t used = allocated;
+		return used - std::min(used, pending);
+	}
+
+	ResourceCache::Stage::Stage()
+		: numThreads(1),
+		workTimeUs(0)
+	{
+	}
+
+	ResourceCache::LoadJob::LoadJob()
+		: res(0),
+		generation(0),
+		source(FileTier),
+		workUs(0),
+		requestTime(cl::now())
+	{
+	}
+
+	ResourceCache::HandleDeleter::HandleDeleter(ResourceCache* cache)
+		: cache(cache)
+	{
+	}
+
+	void ResourceCache::HandleDeleter::operator()(ResourceHandle* handle) const
+	{
+		cache->destroyHandle(handle);
+	}
+
+	ResourceCache::LoadTarget::LoadTarget(ResourceCache* cache, ResId res)
+		: cache(cache),
+		res(res)
+	{
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::LoadTarget::allocate(uint64_t size)
+	{
+		Buffer buffer(cache->allocate(size, res), (size_t)size);
+		if (buffer.data() == nullptr)
+		{
+			// Out of cache memory
+			return nullptr;
+		}
+
+		return cache->adopt(new ResourceHandle(res, std::move(buffer), cache));
+	}
+
+	ResourceCache::CacheAllocation::CacheAllocation(ResourceCache* cache, ResId res, uint64_t size)
+		: cache(cache),
+		res(res),
+		data(nullptr),
+		size(size)
+	{
+		data = cache->allocate(size, res);
+	}
+
+	ResourceCache::CacheAllocation::~CacheAllocation()
+	{
+		if (data)
+		{
+			delete[] data;
+			cache->memoryHasBeenFreed(size, res);
+		}
+	}
+
+	char* ResourceCache::CacheAllocation::get() const
+	{
+		return data;
+	}
+
+	Buffer ResourceCache::CacheAllocation::release()
+	{
+		Buffer buffer(data, (size_t)size);
+		data = nullptr;
+
+		return buffer;
+	}
+
+	ResourceCache::ScratchReservation::ScratchReservation()
+		: cache(nullptr),
+		bytes(0)
+	{
+	}
+
+	ResourceCache::ScratchReservation::ScratchReservation(ResourceCache* cache, uint64_t bytes)
+		: cache(cache),
+		bytes(bytes)
+	{
+	}
+
+	ResourceCache::ScratchReservation::ScratchReservation(ScratchReservation&& other)
+		: cache(other.cache),
+		bytes(other.bytes)
+	{
+		other.cache = nullptr;
+		other.bytes = 0;
+	}
+
+	ResourceCache::ScratchReservation::~ScratchReservation()
+	{
+		release();
+	}
+
+	ResourceCache::ScratchReservation& ResourceCache::ScratchReservation::operator=(ScratchReservation&& other)
+	{
+		std::swap(cache, other.cache);
+		std::swap(bytes, other.bytes);
+
+		return *this;
+	}
+
+	void ResourceCache::ScratchReservation::release()
+	{
+		if (cache && bytes > 0)
+		{
+			cache->releaseScratch(bytes);
+		}
+		cache = nullptr;
+		bytes = 0;
+	}
+
+	ResourceCache::FileLease::FileLease()
+		: cache(nullptr)
+	{
+	}
+
+	ResourceCache::FileLease::FileLease(ResourceCache* cache)
+		: cache(cache)
+	{
+	}
+
+	ResourceCache::FileLease::FileLease(FileLease&& other)
+		: cache(other.cache)
+	{
+		other.cache = nullptr;
+	}
+
+	ResourceCache::FileLease::~FileLease()
+	{
+		release();
+	}
+
+	ResourceCache::FileLease& ResourceCache::FileLease::operator=(FileLease&& other)
+	{
+		std::swap(cache, other.cache);
+
+		return *this;
+	}
+
+	void ResourceCache::FileLease::release()
+	{
+		if (cache)
+		{
+			cache->releaseFileLease();
+		}
+		cache = nullptr;
+	}
+
+	ResourceCache::TierCounters::TierCounters()
+		: hits(0),
+		misses(0),
+		timeUs(0)
+	{
+	}
+
+	ResourceCache::InFlightLoad::InFlightLoad()
+		: done(false),
+		sharers(0),
+		lowPriority(false),
+		claimed(false),
+		worker()
+	{
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::InFlightLoad::wait()
+	{
+		std::unique_lock<std::mutex> waitLock(lock);
+		while (!done)
+		{
+			loaded.wait(waitLock);
+		}
+
+		return handle;
+	}
+
+	ResourceCache::Shard& ResourceCache::getShard(ResId res)
+	{
+		// Fibonacci hashing spreads sequential ids and maps the hash onto [0, numShards)
+		uint32_t hash = res * 2654435769u;
+		return *shards[(size_t)(((uint64_t)hash * shards.size()) >> 32)];
+	}
+
 	std::shared_ptr<ResourceHandle> ResourceCache::find(ResId res)
 	{
-		std::unique_lock<std::recursive_mutex> lLock(leastRecentlyUsedLock, std::defer_lock);
-		std::unique_lock<std::recursive_mutex> rLock(resourcesLock, std::defer_lock);
-		std::lock(lLock, rLock);
+		Shard& shard = getShard(res);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		auto iter = shard.resources.find(res);
+		if (iter != shard.resources.end())
+		{
+			return iter->second;
+		}
+
+		auto weakIter = shard.weakResources.find(res);
+		if (weakIter != shard.weakResources.end())
+		{
+			std::shared_ptr<ResourceHandle> handle = weakIter->second.lock();
+			shard.weakResources.erase(res);
+
+			if (handle)
+			{
+				metrics.add(CacheMetrics::Resurrections);
+				shard.resources[res] = handle;
+				if (shard.pins.count(res) == 0)
+				{
+					shard.policy->inserted(res, handle->getChargedSize());
+				}
+
+				return handle;
+			}
+		}
+
+		return std::shared_ptr<ResourceHandle>();
+	}
+
+	void ResourceCache::update(std::shared_ptr<ResourceHandle> handle)
+	{
+		Shard& shard = getShard(handle->resource);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		shard.policy->accessed(handle->resource);
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::load(ResId res)
+	{
+		// The pipeline stages run back to back on the calling thread
+		LoadJob job;
+		job.res = res;
+		job.loader = findLoader(res);
+
+		GENA_TRACE(Trace::Info, Trace::LoadBegin, res, 0);
+		cl::time_point startTime = cl::now();
+		// A pipeline thread may hold scratch memory itself, or jobs a reload
+		// waits for may be queued behind it, so waiting could never end
+		readStored(job, !isPipelineThread());
+		decode(job);
+		job.scratch.release();
+		job.fileLease.release();
+		job.workUs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+
+		recordLoad(job);
+		return insertLoaded(res, job.handle, job.generation);
+	}
+
+	std::shared_ptr<IResourceLoader> ResourceCache::findLoader(ResId res) const
+	{
+		const ResourceType type = file->getResourceTypeCode(res);
+
+		for (const auto& entry : resourceLoaders)
+		{
+			if (entry.first == type)
+			{
+				return entry.second;
+			}
+		}
+
+		if (!fallbackLoader)
+		{
+			throw std::runtime_error("Default resource loader not found!");
+		}
+
+		return fallbackLoader;
+	}
+
+	void ResourceCache::readStored(LoadJob& job, bool mayWait)
+	{
+		// Sizes and contents must come from the same version of the file
+		// until the resource has been decoded
+		job.fileLease = acquireFileLease(mayWait);
+		job.generation = fileGeneration;
+
+		const bool useRaw = job.loader->useRawFile();
+
+		IResourceFile::MappedView view;
+		if (useRaw && file->mapRawResource(job.res, view))
+		{
+			// Served straight from the mapped archive, nothing to copy or charge
+			job.handle = adopt(new ResourceHandle(job.res, Buffer::view(view.data, (size_t)view.size), this, view.mapping));
+			return;
+		}
+
+		if (useRaw && compressed.getBudget() > 0)
+		{
+			uint64_t rawSize = compressed.getRawSize(job.res);
+			if (rawSize > 0)
+			{
+				// Given back if take fails or throws
+				CacheAllocation memory(this, job.res, rawSize);
+				if (memory.get() == nullptr)
+				{
+					// Out of cache memory
+					return;
+				}
+
+				// Only fails if the resource was taken by a concurrent load
+				if (compressed.take(job.res, memory.get(), rawSize))
+				{
+					metrics.add(CacheMetrics::BytesDecompressed, rawSize);
+					job.source = CompressedTier;
+					job.handle = adopt(new ResourceHandle(job.res, memory.release(), this));
+					return;
+				}
+			}
+		}
+
+		uint32_t version = useRaw ? 0 : job.loader->getVersion();
+		if (version != 0 && diskCache.isEnabled())
+		{
+			uint32_t checksum = file->getResourceChecksum(job.res);
+			if (checksum != 0 && diskCache.find(job.res, checksum, version, view))
+			{
+				// Loaded by an earlier run, nothing left to read or parse
+				job.source = DiskCacheTier;
+				job.handle = adopt(new ResourceHandle(job.res, Buffer::view(view.data, (size_t)view.size), this, view.mapping));
+				return;
+			}
+		}
+
+		if (!useRaw && !file->needsDecode(job.res) && file->mapRawResource(job.res, view))
+		{
+			// Parsed straight out of the mapped archive, without reading a copy
+			job.stored = Buffer::view(view.data, (size_t)view.size);
+			job.storedMapping = view.mapping;
+			return;
+		}
+
+		uint64_t storedSize = file->getStoredResourceSize(job.res);
+
+		if (useRaw && !file->needsDecode(job.res))
+		{
+			// The bytes read are the resource, read them into cache memory right away
+			CacheAllocation memory(this, job.res, storedSize);
+			if (memory.get() == nullptr)
+			{
+				// Out of cache memory
+				return;
+			}
+
+			file->getStoredResource(job.res, memory.get());
+			metrics.add(CacheMetrics::BytesLoaded, storedSize);
+			job.handle = adopt(new ResourceHandle(job.res, memory.release(), this));
+			return;
+		}
+
+		// Everything the load needs outside the cache is set aside at once,
+		// so that a load never waits while holding scratch memory
+		uint64_t scratchSize = storedSize;
+		if (!useRaw && file->needsDecode(job.res))
+		{
+			scratchSize += file->getRawResourceSize(job.res);
+		}
+		job.scratch = reserveScratch(scratchSize, mayWait);
+
+		job.stored = Buffer((size_t)storedSize);
+		file->getStoredResource(job.res, job.stored.data());
+		metrics.add(CacheMetrics::BytesLoaded, storedSize);
+	}
+
+	ResourceCache::ScratchReservation ResourceCache::reserveScratch(uint64_t bytes, bool mayWait)
+	{
+		std::unique_lock<std::mutex> lock(scratchLock);
+
+		if (mayWait && scratchBytes > 0 && scratchBytes + bytes > scratchLimit)
+		{
+			cl::time_point startTime = cl::now();
+			++admissionWaits;
+
+			while (scratchBytes > 0 && scratchBytes + bytes > scratchLimit)
+			{
+				scratchFreed.wait(lock);
+			}
+
+			admissionWaitUs += std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+		}
+
+		scratchBytes += bytes;
+
+		uint64_t prevPeak = scratchPeak;
+		while (scratchBytes > prevPeak && !scratchPeak.compare_exchange_weak(prevPeak, scratchBytes))
+		{
+		}
+
+		uint64_t total = scratchBytes + allocated;
+		uint64_t prevTotal = scratchPeakTotal;
+		while (total > prevTotal && !scratchPeakTotal.compare_exchange_weak(prevTotal, total))
+		{
+		}
+
+		return ScratchReservation(this, bytes);
+	}
+
+	void ResourceCache::releaseScratch(uint64_t bytes)
+	{
+		{
+			std::lock_guard<std::mutex> lock(scratchLock);
+			scratchBytes -= bytes;
+		}
+		scratchFreed.notify_all();
+	}
+
+	ResourceCache::FileLease ResourceCache::acquireFileLease(bool mayWait)
+	{
+		std::unique_lock<std::mutex> lock(fileLeaseLock);
+
+		// A reload waiting for the leases may be waiting on jobs queued
+		// behind a pipeline thread, so those only wait for the swap itself,
+		// which waits on nobody. The reload then waits for them in turn.
+		while (mayWait ? fileReloading : fileSwapping)
+		{
+			fileLeasesChanged.wait(lock);
+		}
+
+		++fileLeases;
+		return FileLease(this);
+	}
+
+	void ResourceCache::releaseFileLease()
+	{
+		{
+			std::lock_guard<std::mutex> lock(fileLeaseLock);
+			if (--fileLeases > 0)
+			{
+				return;
+			}
+		}
+		fileLeasesChanged.notify_all();
+	}
+
+	void ResourceCache::decode(LoadJob& job)
+	{
+		if (job.handle || job.stored.data() == nullptr)
+		{
+			return;
+		}
+
+		const bool useRaw = job.loader->useRawFile();
+		Buffer rawBuffer;
+
+		if (file->needsDecode(job.res) && useRaw)
+		{
+			uint64_t rawSize = file->getRawResourceSize(job.res);
+			CacheAllocation memory(this, job.res, rawSize);
+			if (memory.get() == nullptr)
+			{
+				// Out of cache memory
+				return;
+			}
+
+			file->decodeResource(job.res, job.stored.data(), job.stored.size(), memory.get());
+			metrics.add(CacheMetrics::BytesDecompressed, rawSize);
+			job.stored.clear();
+			rawBuffer = memory.release();
+		}
+		else if (file->needsDecode(job.res))
+		{
+			// Only input for the loader, scratch rather than cache memory
+			uint64_t rawSize = file->getRawResourceSize(job.res);
+			rawBuffer = Buffer(new char[(size_t)rawSize], (size_t)rawSize);
+
+			file->decodeResource(job.res, job.stored.data(), job.stored.size(), rawBuffer.data());
+			metrics.add(CacheMetrics::BytesDecompressed, rawSize);
+			job.stored.clear();
+		}
+		else
+		{
+			rawBuffer = std::move(job.stored);
+		}
+
+		if (useRaw)
+		{
+			job.handle = adopt(new ResourceHandle(job.res, std::move(rawBuffer), this));
+			return;
+		}
+
+		LoadTarget target(this, job.res);
+		std::shared_ptr<ResourceHandle> handle(job.loader->load(rawBuffer, target));
+		if (handle)
+		{
+			job.handle = handle;
+
+			uint32_t version = job.loader->getVersion();
+			uint32_t checksum = file->getResourceChecksum(job.res);
+			if (version != 0 && checksum != 0 && diskCache.isEnabled())
+			{
+				diskCache.store(job.res, checksum, version, handle->getBuffer().data(), handle->getBuffer().size());
+			}
+		}
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::insertLoaded(ResId res, std::shared_ptr<ResourceHandle> handle, uint32_t generation)
+	{
+		if (!handle)
+		{
+			return handle;
+		}
+
+		Shard& shard = getShard(res);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		// Reloads invalidate under the shard lock too, so a load read before
+		// one is either in the cache by then or turned away here
+		if (generation != fileGeneration)
+		{
+			handle->stale = true;
+			return handle;
+		}
+
+		// Never replace a live handle, users of the old one would end up
+		// with a different copy than everyone asking from now on
+		std::shared_ptr<ResourceHandle> existing = find(res);
+		if (existing)
+		{
+			return existing;
+		}
+
+		shard.resources[res] = handle;
+		if (shard.pins.count(res) == 0)
+		{
+			shard.policy->inserted(res, handle->getChargedSize());
+		}
+
+		return handle;
+	}
+
+	void ResourceCache::invalidate(ResId res)
+	{
+		compressed.remove(res);
+
+		Shard& shard = getShard(res);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		auto iter = shard.resources.find(res);
+		if (iter != shard.resources.end())
+		{
+			iter->second->stale = true;
+			if (shard.pins.count(res) == 0)
+			{
+				shard.policy->removed(res);
+			}
+			shard.resources.erase(iter);
+		}
+
+		auto weakIter = shard.weakResources.find(res);
+		if (weakIter != shard.weakResources.end())
+		{
+			std::shared_ptr<ResourceHandle> handle = weakIter->second.lock();
+			if (handle)
+			{
+				handle->stale = true;
+			}
+			shard.weakResources.erase(weakIter);
+		}
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::loadInFlight(ResId res, std::shared_ptr<InFlightLoad> entry)
+	{
+		std::shared_ptr<ResourceHandle> handle;
+
+		++numLoads;
+		try
+		{
+			handle = load(res);
+		}
+		catch (...)
+		{
+			// Release the waiters empty handed before passing the error on
+			completeInFlight(res, entry, handle);
+			throw;
+		}
+
+		completeInFlight(res, entry, handle);
+		return handle;
+	}
+
+	void ResourceCache::completeInFlight(ResId res, std::shared_ptr<InFlightLoad> entry, std::shared_ptr<ResourceHandle> handle)
+	{
+		uint32_t sharers;
+		{
+			// The resource is already in its shard, so anyone arriving after
+			// this will find it there instead of waiting
+			std::lock_guard<std::mutex> lock(inFlightLock);
+			inFlight.erase(res);
+			sharers = entry->sharers;
+		}
+
+		if (handle)
+		{
+			duplicateBytesSaved += sharers * (uint64_t)handle->getBuffer().size();
+		}
+
+		std::vector<LoadCallback> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(entry->lock);
+			entry->done = true;
+			entry->handle = handle;
+			callbacks.swap(entry->callbacks);
+		}
+		entry->loaded.notify_all();
+
+		for (const auto& callback : callbacks)
+		{
+			if (handle || callback.notifyFailure)
+			{
+				callback.callback(handle, callback.userData);
+			}
+		}
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::waitInFlight(std::shared_ptr<InFlightLoad> entry)
+	{
+		uint32_t waiting = ++currentWaiters;
+		uint32_t prevMax = maxWaiters;
+		while (waiting > prevMax && !maxWaiters.compare_exchange_weak(prevMax, waiting))
+		{
+		}
+
+		// A pipeline thread keeps its stage going while it waits, the load
+		// may well be queued behind it
+		const PipelineStage stage = findPipelineStage();
+		std::shared_ptr<ResourceHandle> handle = stage == NumPipelineStages ? entry->wait() : helpInFlight(stage, entry);
+		--currentWaiters;
+
+		return handle;
+	}
+
+	void ResourceCache::startPipeline()
+	{
+		for (int stage = 0; stage < NumPipelineStages; ++stage)
+		{
+			// Jobs are only queued up for the I/O stage, which must never
+			// block a caller of preload
+			stages[stage].queue.setCapacity(stage == IoStage ? 0 : pipelineDepth);
+
+			for (unsigned int i = 0; i < stages[stage].numThreads; ++i)
+			{
+				stages[stage].threads.push_back(std::thread(&ResourceCache::runStage, this, (PipelineStage)stage));
+			}
+		}
+	}
+
+	void ResourceCache::stopPipeline()
+	{
+		// Stop one stage at a time so that queued jobs can drain through the rest
+		for (int stage = 0; stage < NumPipelineStages; ++stage)
+		{
+			stages[stage].queue.close();
+			for (auto& thread : stages[stage].threads)
+			{
+				thread.join();
+			}
+			stages[stage].threads.clear();
+		}
+	}
+
+	void ResourceCache::runStage(PipelineStage stage)
+	{
+		static const char* const stageNames[NumPipelineStages] = { "I/O stage", "Decode stage", "Completion stage" };
+		Trace::setThreadName(stageNames[stage]);
+
+		std::unique_ptr<LoadJob> job;
+		while (stages[stage].queue.pop(job))
+		{
+			runJob(stage, std::move(job));
+		}
+	}
+
+	void ResourceCache::runJob(PipelineStage stage, std::unique_ptr<LoadJob> job)
+	{
+		if (stage == IoStage && job->entry->claimed.exchange(true))
+		{
+			// Someone else got to this load first
+			return;
+		}
+
+		const ResId res = job->res;
+		const std::shared_ptr<InFlightLoad> entry = job->entry;
+		setWorker(*entry, std::this_thread::get_id());
+
+		cl::time_point startTime = cl::now();
+
+		try
+		{
+			switch (stage)
+			{
+			case IoStage:
+				GENA_TRACE(Trace::Info, Trace::LoadBegin, res, 0);
+				readStored(*job, true);
+				break;
+
+			case DecodeStage:
+				decode(*job);
+				job->scratch.release();
+				job->fileLease.release();
+				break;
+
+			case CompletionStage:
+				// Callbacks may load more themselves, which must not wait on a reload waiting on this
+				job->fileLease.release();
+				recordLoad(*job);
+				job->handle = insertLoaded(res, job->handle, job->generation);
+				setWorker(*entry, std::thread::id());
+				completeInFlight(res, entry, job->handle);
+				job.reset();
+				break;
+
+			default:
+				break;
+			}
+		}
+		catch (std::exception&)
+		{
+			// Waiters see the failure as an empty handle. The job goes first,
+			// so callbacks don't run holding its scratch memory.
+			GENA_TRACE(Trace::Error, Trace::LoadFailed, res, 0);
+			job.reset();
+			setWorker(*entry, std::thread::id());
+			completeInFlight(res, entry, std::shared_ptr<ResourceHandle>());
+		}
+
+		uint64_t workUs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+		stages[stage].workTimeUs += workUs;
+
+		if (job)
+		{
+			job->workUs += workUs;
+			setWorker(*entry, std::thread::id());
+
+			// Resources done on the I/O stage, like mapped ones, skip decoding
+			PipelineStage next = (stage == IoStage && job->handle) ? CompletionStage : (PipelineStage)(stage + 1);
+			if (!stages[next].queue.push(std::move(job)))
+			{
+				completeInFlight(res, entry, std::shared_ptr<ResourceHandle>());
+			}
+		}
+	}
+
+	void ResourceCache::setWorker(InFlightLoad& entry, std::thread::id worker)
+	{
+		std::lock_guard<std::mutex> lock(entry.lock);
+		entry.worker = worker;
+	}
+
+	ResourceCache::PipelineStage ResourceCache::findPipelineStage() const
+	{
+		const std::thread::id me = std::this_thread::get_id();
+
+		for (int stage = 0; stage < NumPipelineStages; ++stage)
+		{
+			for (const auto& thread : stages[stage].threads)
+			{
+				if (thread.get_id() == me)
+				{
+					return (PipelineStage)stage;
+				}
+			}
+		}
+
+		return NumPipelineStages;
+	}
+
+	bool ResourceCache::isPipelineThread() const
+	{
+		return findPipelineStage() != NumPipelineStages;
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::helpInFlight(PipelineStage stage, std::shared_ptr<InFlightLoad> entry)
+	{
+		for (;;)
+		{
+			{
+				std::lock_guard<std::mutex> lock(entry->lock);
+				if (entry->done)
+				{
+					return entry->handle;
+				}
+			}
+
+			// The load may sit behind other work of this stage, which only
+			// moves if this thread keeps doing it
+			std::unique_ptr<LoadJob> job;
+			if (stages[stage].queue.tryPop(job))
+			{
+				runJob(stage, std::move(job));
+				continue;
+			}
+
+			// Work can arrive without the entry changing, so check back often
+			std::unique_lock<std::mutex> lock(entry->lock);
+			if (!entry->done)
+			{
+				entry->loaded.wait_for(lock, std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+	void ResourceCache::free(std::shared_ptr<ResourceHandle> gonner)
+	{
+		Shard& shard = getShard(gonner->resource);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		shard.resources.erase(gonner->resource);
+		shard.policy->removed(gonner->resource);
+
+		std::weak_ptr<ResourceHandle> weakGonner = gonner;
+		gonner.reset();
+		gonner = weakGonner.lock();
+
+		if (gonner)
+		{
+			shard.weakResources[gonner->resource] = gonner;
+		}
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::adopt(ResourceHandle* handle)
+	{
+		return std::shared_ptr<ResourceHandle>(handle, HandleDeleter(this));
+	}
+
+	void ResourceCache::destroyHandle(ResourceHandle* handle)
+	{
+		if (!deferredFree)
+		{
+			delete handle;
+			return;
+		}
+
+		// Counted before the push so room is never made twice for the same
+		// bytes, and uncounted by collectGarbage before they are freed
+		getShard(handle->resource).pendingFree += handle->getChargedSize();
+
+		// Lock-free push, collectGarbage takes the whole list at once
+		ResourceHandle* head = deadHandles;
+		do
+		{
+			handle->nextDead = head;
+		} while (!deadHandles.compare_exchange_weak(head, handle));
+	}
+
+	size_t ResourceCache::collectGarbage()
+	{
+		// One collector at a time keeps the batch timings meaningful
+		std::lock_guard<std::mutex> lock(collectLock);
+
+		ResourceHandle* dead = deadHandles.exchange(nullptr);
+		if (!dead)
+		{
+			return 0;
+		}
+
+		cl::time_point startTime = cl::now();
+		size_t numHandles = 0;
+
+		while (dead)
+		{
+			ResourceHandle* next = dead->nextDead;
+			getShard(dead->resource).pendingFree -= dead->getChargedSize();
+			delete dead;
+			dead = next;
+			++numHandles;
+		}
+
+		uint64_t batchUs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+		numFreed += numHandles;
+		++freeBatches;
+		lastFreeBatchUs = batchUs;
+		totalFreeUs += batchUs;
+		if (batchUs > maxFreeBatchUs)
+		{
+			maxFreeBatchUs = batchUs;
+		}
+
+		return numHandles;
+	}
+
+	void ResourceCache::recordLoad(const LoadJob& job)
+	{
+		if (!job.handle)
+		{
+			return;
+		}
+
+		GENA_TRACE(Trace::Info, Trace::LoadEnd, job.res, job.source);
+
+		metrics.add(CacheMetrics::Loads);
+		recordAccess(AccessTrace::Load, job.res, job.handle->getChargedSize());
+		metrics.recordLatency(file->getResourceTypeCode(job.res),
+			std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - job.requestTime).count());
+
+		TierCounters& tier = tiers[job.source];
+		++tier.hits;
+		tier.timeUs += job.workUs;
+
+		if (job.source != FileTier)
+		{
+			return;
+		}
+
+		if (job.loader->useRawFile())
+		{
+			if (compressed.getBudget() > 0)
+			{
+				++tiers[CompressedTier].misses;
+			}
+		}
+		else if (diskCache.isEnabled() && job.loader->getVersion() != 0)
+		{
+			++tiers[DiskCacheTier].misses;
+		}
+	}
+
+	void ResourceCache::handleDestroyed(const ResourceHandle& handle)
+	{
+		if (!compressEvicted || handle.stale || handle.getBuffer().isView() || handle.getBuffer().size() == 0)
+		{
+			return;
+		}
+
+		// Only raw resources can be handed back as they were, anything a
+		// loader has built would have to be loaded again anyway
+		if (findLoader(handle.resource)->useRawFile())
+		{
+			compressed.store(handle.resource, handle.getBuffer().data(), handle.getBuffer().size());
+		}
+	}
+
+	bool ResourceCache::makeRoom(Shard& shard, uint64_t size)
+	{
+		if (size > cacheSize)
+		{
+			throw std::runtime_error("Object to large for cache");
+		}
+
+		if (size > shard.budget)
+		{
+			rebalanceBudgets(&shard, size);
+		}
+
+		shard.policy->setCapacity(shard.budget);
+
+		// Dead handles waiting for collectGarbage count as freed already,
+		// evicting more for them would just empty the shard
+		if (shard.liveBytes() + size <= shard.budget)
+		{
+			return true;
+		}
+
+		// Make room for more than this allocation so the next few don't
+		// have to evict one resource each
+		uint64_t target = std::max((uint64_t)(shard.budget * lowWatermark), size);
+		bool evictedAny = false;
+
+		while (shard.liveBytes() + size > target && !shard.policy->empty())
+		{
+			freeOneResource(shard);
+			++numEvicted;
+			evictedAny = true;
+		}
+
+		if (evictedAny)
+		{
+			++evictionBatches;
+		}
+
+		return shard.liveBytes() + size <= shard.budget;
+	}
+
+	char* ResourceCache::allocate(uint64_t size, ResId res)
+	{
+		if (shards.size() > 1 && ++allocsSinceRebalance >= rebalanceInterval)
+		{
+			allocsSinceRebalance = 0;
+			rebalanceBudgets(nullptr, 0);
+		}
+
+		Shard& shard = getShard(res);
+		shard.demand += size;
+
+		const cl::time_point deadline = cl::now() + overcommitTimeout;
+		bool waited = false;
+		cl::time_point waitStart;
+		char* mem = nullptr;
+
+		for (;;)
+		{
+			// Read before trying, anything freed after this ends the wait below right away
+			const uint64_t freesBefore = roomFrees;
+
+			bool fits;
+			{
+				std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+				fits = makeRoom(shard, size);
+				if (fits || overcommitPolicy == EvictUnpinned)
+				{
+					if (!fits)
+					{
+						++numOvercommits;
+					}
+
+					mem = new char[(size_t)size];
+					shard.allocated += size;
+
+					uint64_t alloced = allocated += size;
+					uint64_t prevMax = maxAllocated;
+					while (alloced > prevMax && !maxAllocated.compare_exchange_weak(prevMax, alloced))
+					{
+					}
+					break;
+				}
+			}
+
+			// Dead handles hold their memory until collected, which may well
+			// be up to this thread, so collect them instead of waiting on them
+			if (deadHandles.load() != nullptr && collectGarbage() > 0)
+			{
+				continue;
+			}
+
+			if (overcommitPolicy == RejectOvercommit || cl::now() >= deadline)
+			{
+				++numRejected;
+				break;
+			}
+
+			if (!waited)
+			{
+				waited = true;
+				waitStart = cl::now();
+				++numRoomWaits;
+			}
+
+			// Resources still in use are freed when their last handle goes,
+			// which is what wakes this up
+			std::unique_lock<std::mutex> lock(roomLock);
+			while (roomFrees == freesBefore && cl::now() < deadline)
+			{
+				roomFreed.wait_until(lock, deadline);
+			}
+		}
+
+		if (waited)
+		{
+			roomWaitUs += std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - waitStart).count();
+		}
+
+		if (backgroundEviction && shard.liveBytes() > shard.budget * highWatermark)
+		{
+			housekeepingWake.notify_one();
+		}
+
+		updatePressure(mem == nullptr);
+		return mem;
+	}
+
+	void ResourceCache::runHousekeeping()
+	{
+		Trace::setThreadName("Housekeeping");
+
+		std::unique_lock<std::mutex> lock(housekeepingLock);
+
+		while (!stopHousekeeping)
+		{
+			// Also wakes up now and then, in case a notification was missed
+			housekeepingWake.wait_for(lock, std::chrono::milliseconds(100));
+
+			lock.unlock();
+			for (auto& shard : shards)
+			{
+				if (trimShard(*shard))
+				{
+					++backgroundBatches;
+				}
+			}
+			collectGarbage();
+			lock.lock();
+		}
+	}
+
+	bool ResourceCache::trimShard(Shard& shard)
+	{
+		std::vector<std::shared_ptr<ResourceHandle>> victims;
+
+		{
+			std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+			uint64_t used = shard.liveBytes();
+			if (used <= shard.budget * highWatermark)
+			{
+				return false;
+			}
+
+			const uint64_t target = (uint64_t)(shard.budget * lowWatermark);
+			while (used > target && !shard.policy->empty())
+			{
+				ResId victim = shard.policy->selectVictim();
+				std::shared_ptr<ResourceHandle> handle = shard.resources[victim];
+				shard.resources.erase(victim);
+				shard.weakResources[victim] = handle;
+				GENA_TRACE(Trace::Info, Trace::Evict, victim, handle->getChargedSize());
+				metrics.add(CacheMetrics::Evictions);
+				recordAccess(AccessTrace::Evict, victim, handle->getChargedSize());
+
+				// Resources still used elsewhere stay until they are let go of
+				if (handle.use_count() == 1)
+				{
+					used -= std::min(used, handle->getChargedSize());
+				}
+
+				victims.push_back(std::move(handle));
+				++backgroundEvicted;
+			}
+		}
+
+		// Handles die here, on this thread and outside the shard lock, unless
+		// someone picked one up again in the meantime
+		victims.clear();
+		return true;
+	}
+
+	void ResourceCache::updatePressure(bool critical)
+	{
+		const uint64_t used = allocated;
+
+		int level = pressureLevel;
+		int newLevel;
+
+		if (critical || used > cacheSize)
+		{
+			newLevel = PressureCritical;
+		}
+		else if (used > cacheSize * highWatermark)
+		{
+			newLevel = PressureHigh;
+		}
+		else if (used < cacheSize * lowWatermark)
+		{
+			newLevel = PressureNormal;
+		}
+		else
+		{
+			// Between the watermarks the level stays, unless it was critical
+			newLevel = std::min(level, (int)PressureHigh);
+		}
+
+		if (newLevel != level && pressureLevel.compare_exchange_strong(level, newLevel) && pressureCallback)
+		{
+			pressureCallback((PressureLevel)newLevel, used, cacheSize, pressureUserData);
+		}
+	}
+
+	void ResourceCache::freeOneResource(Shard& shard)
+	{
+		ResId victim = shard.policy->selectVictim();
+		std::shared_ptr<ResourceHandle> handle = shard.resources[victim];
+
+		shard.resources.erase(victim);
+		GENA_TRACE(Trace::Info, Trace::Evict, victim, handle->getChargedSize());
+		metrics.add(CacheMetrics::Evictions);
+		recordAccess(AccessTrace::Evict, victim, handle->getChargedSize());
+
+		std::weak_ptr<ResourceHandle> weakGonner = handle;
+		handle.reset();
+		handle = weakGonner.lock();
+
+		if (handle)
+		{
+			shard.weakResources[handle->resource] = handle;
+		}
+	}
+
+	void ResourceCache::memoryHasBeenFreed(uint64_t size, ResId resId)
+	{
+		Shard& shard = getShard(resId);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		shard.allocated -= size;
+		allocated -= size;
+
+		// With deferred freeing a newer handle for the resource may exist by now
+		auto weakIter = shard.weakResources.find(resId);
+		if (weakIter != shard.weakResources.end() && weakIter->second.expired())
+		{
+			shard.weakResources.erase(weakIter);
+		}
+
+		if (overcommitPolicy == WaitForRoom)
+		{
+			std::lock_guard<std::mutex> roomGuard(roomLock);
+			++roomFrees;
+			roomFreed.notify_all();
+		}
+
+		if (pressureLevel != PressureNormal)
+		{
+			updatePressure(false);
+		}
+	}
+
+	void ResourceCache::rebalanceBudgets(Shard* needy, uint64_t need)
+	{
+		const size_t numShards = shards.size();
+		if (numShards == 1)
+		{
+			shards[0]->budget = cacheSize;
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(rebalanceLock, std::defer_lock);
+		if (needy)
+		{
+			lock.lock();
+		}
+		else if (!lock.try_lock())
+		{
+			// Somebody else is already rebalancing
+			return;
+		}
+
+		// Every shard keeps a floor so a cold shard can still load something,
+		// the rest is split by how much each shard holds and has recently asked for.
+		const uint64_t minBudget = cacheSize / (numShards * 4);
+		const uint64_t distributable = cacheSize - minBudget * numShards;
+
+		std::vector<uint64_t> weights(numShards);
+		uint64_t totalWeight = 0;
+		for (size_t i = 0; i < numShards; ++i)
+		{
+			weights[i] = shards[i]->allocated + shards[i]->demand.exchange(0);
+			totalWeight += weights[i];
+		}
+
+		std::vector<uint64_t> budgets(numShards);
+		uint64_t assigned = 0;
+		for (size_t i = 0; i < numShards; ++i)
+		{
+			double share = totalWeight > 0 ? (double)weights[i] / totalWeight : 1.0 / numShards;
+			budgets[i] = minBudget + (uint64_t)(distributable * share);
+			assigned += budgets[i];
+		}
+		budgets[numShards - 1] += cacheSize - assigned;
+
+		if (needy)
+		{
+			// Guarantee the requesting shard can fit the object, taking the
+			// deficit from the other shards' slack before touching their floors.
+			size_t needyIndex = 0;
+			while (shards[needyIndex].get() != needy)
+			{
+				++needyIndex;
+			}
+
+			for (uint64_t minLeft = minBudget; budgets[needyIndex] < need; minLeft = 0)
+			{
+				for (size_t i = 0; i < numShards && budgets[needyIndex] < need; ++i)
+				{
+					if (i == needyIndex || budgets[i] <= minLeft)
+					{
+						continue;
+					}
+
+					uint64_t take = std::min(budgets[i] - minLeft, need - budgets[needyIndex]);
+					budgets[i] -= take;
+					budgets[needyIndex] += take;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < numShards; ++i)
+		{
+			shards[i]->budget = budgets[i];
+		}
+	}
+
+	void ResourceCache::pin(ResId res)
+	{
+		Shard& shard = getShard(res);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		// Pinned resources are hidden from the eviction policy
+		if (shard.pins[res]++ == 0 && shard.resources.count(res) > 0)
+		{
+			shard.policy->removed(res);
+		}
+	}
+
+	void ResourceCache::unpin(ResId res)
+	{
+		Shard& shard = getShard(res);
+		std::lock_guard<std::recursive_mutex> lock(shard.lock);
+
+		auto pinned = shard.pins.find(res);
+		if (pinned == shard.pins.end() || --pinned->second > 0)
+		{
+			return;
+		}
+		shard.pins.erase(pinned);
+
+		auto iter = shard.resources.find(res);
+		if (iter != shard.resources.end())
+		{
+			shard.policy->inserted(res, iter->second->getChargedSize());
+		}
+	}
+
+	void ResourceCache::setMemberLoaded(std::shared_ptr<ResourceHandle> handle, void* userData)
+	{
+		finishSetMember(static_cast<SetLoad*>(userData), handle != nullptr);
+	}
+
+	void ResourceCache::finishSetMember(SetLoad* setLoad, bool loaded)
+	{
+		if (!loaded)
+		{
+			setLoad->failed = true;
+		}
+
+		if (--setLoad->remaining == 0)
+		{
+			if (setLoad->callback)
+			{
+				setLoad->callback(setLoad->name, !setLoad->failed, setLoad->userData);
+			}
+			delete setLoad;
+		}
+	}
+
+	ResourceCache::ResourceCache(uint64_t sizeInMiB, std::unique_ptr<IResourceFile>&& resFile, unsigned int numShards)
+		: allocsSinceRebalance(0),
+		file(std::move(resFile)),
+		fileLeases(0),
+		fileReloading(false),
+		fileSwapping(false),
+		fileGeneration(0),
+		numReloads(0),
+		failedReloads(0),
+		reloadedResources(0),
+		lastReloadUs(0),
+		maxReloadUs(0),
+		cacheSize(sizeInMiB * 1024 * 1024),
+		allocated(0),
+		maxAllocated(0),
+		overcommitPolicy(EvictUnpinned),
+		overcommitTimeout(1000),
+		highWatermark(0.95f),
+		lowWatermark(0.9f),
+		pressureCallback(nullptr),
+		pressureUserData(nullptr),
+		pressureLevel(PressureNormal),
+		roomFrees(0),
+		evictionBatches(0),
+		numEvicted(0),
+		numOvercommits(0),
+		numRejected(0),
+		numRoomWaits(0),
+		roomWaitUs(0),
+		backgroundEviction(false),
+		stopHousekeeping(false),
+		backgroundBatches(0),
+		backgroundEvicted(0),
+		deferredFree(false),
+		deadHandles(nullptr),
+		numFreed(0),
+		freeBatches(0),
+		lastFreeBatchUs(0),
+		maxFreeBatchUs(0),
+		totalFreeUs(0),
+		numLoads(0),
+		coalescedRequests(0),
+		duplicateBytesSaved(0),
+		pipelineCopies(0),
+		currentWaiters(0),
+		maxWaiters(0),
+		pipelineDepth(16),
+		scratchLimit(cacheSize / 4),
+		scratchBytes(0),
+		scratchPeak(0),
+		scratchPeakTotal(0),
+		admissionWaits(0),
+		admissionWaitUs(0),
+		compressed(0),
+		compressEvicted(false)
+	{
+		if (numShards == 0)
+		{
+			throw std::runtime_error("A cache needs at least one shard");
+		}
+
+		for (unsigned int i = 0; i < numShards; ++i)
+		{
+			shards.push_back(std::unique_ptr<Shard>(new Shard()));
+			shards.back()->policy = LruEvictionPolicy::create();
+			shards.back()->budget = cacheSize / numShards;
+		}
+		shards.back()->budget += cacheSize % numShards;
+
+		unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+		stages[IoStage].numThreads = 2;
+		stages[DecodeStage].numThreads = std::max(1u, numCores - 1);
+		stages[CompletionStage].numThreads = 1;
+	}
+
+	ResourceCache::~ResourceCache()
+	{
+		// Nothing may reload the file while it is being torn down
+		watcher.reset();
+
+		if (housekeeper.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(housekeepingLock);
+				stopHousekeeping = true;
+			}
+			housekeepingWake.notify_one();
+			housekeeper.join();
+		}
+
+		stopPipeline();
+
+		// What happens from here on is not part of the session
+		accessTrace.close();
+
+		// Handles still queued need the cache to release their memory
+		deferredFree = false;
+		collectGarbage();
+
+		// Nothing to come back to after this
+		compressEvicted = false;
+		compressed.clear();
+
+		for (auto& shard : shards)
+		{
+			std::lock_guard<std::recursive_mutex> lock(shard->lock);
+
+			// Sets still loaded don't keep anything alive past the cache
+			for (const auto& pinned : shard->pins)
+			{
+				auto iter = shard->resources.find(pinned.first);
+				if (iter != shard->resources.end())
+				{
+					shard->policy->inserted(pinned.first, iter->second->getChargedSize());
+				}
+			}
+			shard->pins.clear();
+
+			while (!shard->policy->empty())
+			{
+				freeOneResource(*shard);
+			}
+		}
+	}
+
+	void ResourceCache::setEvictionPolicy(EvictionPolicyFactory factory)
+	{
+		if (allocated != 0)
+		{
+			throw std::runtime_error("Eviction policy can not be changed with resources loaded");
+		}
+
+		for (auto& shard : shards)
+		{
+			std::lock_guard<std::recursive_mutex> lock(shard->lock);
+			shard->policy = factory();
+		}
+	}
+
+	void ResourceCache::setIoThreads(unsigned int numThreads)
+	{
+		stages[IoStage].numThreads = std::max(1u, numThreads);
+	}
+
+	void ResourceCache::setDecodeThreads(unsigned int numThreads)
+	{
+		stages[DecodeStage].numThreads = std::max(1u, numThreads);
+	}
+
+	void ResourceCache::setPipelineDepth(size_t depth)
+	{
+		pipelineDepth = std::max((size_t)1, depth);
+	}
+
+	void ResourceCache::setCompressedTierSize(uint64_t sizeInMiB)
+	{
+		compressed.setBudget(sizeInMiB * 1024 * 1024);
+		compressEvicted = sizeInMiB > 0;
+	}
+
+	void ResourceCache::setDecodedCacheDir(const std::string& directory)
+	{
+		diskCache.setDirectory(directory);
+	}
+
+	void ResourceCache::setScratchLimit(uint64_t sizeInMiB)
+	{
+		{
+			std::lock_guard<std::mutex> lock(scratchLock);
+			scratchLimit = sizeInMiB * 1024 * 1024;
+		}
+		scratchFreed.notify_all();
+	}
+
+	void ResourceCache::setOvercommitPolicy(OvercommitPolicy policy, unsigned int timeoutMs)
+	{
+		overcommitPolicy = policy;
+		overcommitTimeout = std::chrono::milliseconds(timeoutMs);
+	}
+
+	void ResourceCache::setWatermarks(float high, float low)
+	{
+		if (low > high || high > 1.f || low <= 0.f)
+		{
+			throw std::runtime_error("Watermarks must satisfy 0 < low <= high <= 1");
+		}
+
+		highWatermark = high;
+		lowWatermark = low;
+	}
+
+	void ResourceCache::setPressureCallback(PressureCallback callback, void* userData)
+	{
+		pressureCallback = callback;
+		pressureUserData = userData;
+	}
+
+	void ResourceCache::setBackgroundEviction(bool enabled)
+	{
+		backgroundEviction = enabled;
+	}
+
+	void ResourceCache::setDeferredFree(bool enabled)
+	{
+		deferredFree = enabled;
+	}
+
+	void ResourceCache::init()
+	{
+		file->open();
+		registerLoader(std::shared_ptr<IResourceLoader>(new DefaultResourceLoader()));
+
+		startPipeline();
+
+		if (backgroundEviction)
+		{
+			housekeeper = std::thread(&ResourceCache::runHousekeeping, this);
+		}
+	}
+
+	void ResourceCache::registerLoader(std::shared_ptr<IResourceLoader> loader)
+	{
+		const ResourceType type = packResourceType(loader->getPattern());
+
+		auto iter = std::find_if(resourceLoaders.begin(), resourceLoaders.end(),
+			[type](const ResourceLoaders::value_type& entry) { return entry.first == type; });
+		if (iter != resourceLoaders.end())
+		{
+			iter->second = loader;
+		}
+		else
+		{
+			resourceLoaders.push_back(std::make_pair(type, loader));
+		}
+
+		if (!fallbackLoader)
+		{
+			fallbackLoader = loader;
+		}
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceCache::getHandle(ResId res)
+	{
+		cl::time_point startTime = cl::now();
 
-		auto iter = resources.find(res);
-		if (iter != resources.end())
+		std::shared_ptr<ResourceHandle> handle(find(res));
+		if (handle)
 		{
-			return iter->second;
+			// Hits only touch the resource's own shard
+			update(handle);
+			GENA_TRACE(Trace::Verbose, Trace::Hit, res, 0);
+			metrics.add(CacheMetrics::Hits);
+			recordAccess(AccessTrace::Request, res, handle->getChargedSize());
+
+			++tiers[MemoryTier].hits;
+			tiers[MemoryTier].timeUs += std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+			return handle;
 		}
 
-		auto weakIter = weakResources.find(res);
-		if (weakIter != weakResources.end())
+		std::shared_ptr<InFlightLoad> entry;
+		bool loadHere = false;
+
 		{
-			std::shared_ptr<ResourceHandle> handle = weakIter->second.lock();
-			weakResources.erase(res);
+			std::lock_guard<std::mutex> lock(inFlightLock);
 
+			handle = find(res);
 			if (handle)
 			{
-				resources[res] = handle;
-				leastRecentlyUsed.push_front(handle);
+				update(handle);
+				GENA_TRACE(Trace::Verbose, Trace::Hit, res, 0);
+				metrics.add(CacheMetrics::Hits);
+				recordAccess(AccessTrace::Request, res, handle->getChargedSize());
 
+				++tiers[MemoryTier].hits;
+				tiers[MemoryTier].timeUs += std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
 				return handle;
 			}
-		}
-
-		return std::shared_ptr<ResourceHandle>();
-	}
 
-	void ResourceCache::update(std::shared_ptr<ResourceHandle> handle)
-	{
-		std::lock_guard<std::recursive_mutex> lock(leastRecentlyUsedLock);
+			++tiers[MemoryTier].misses;
+			GENA_TRACE(Trace::Info, Trace::Miss, res, 0);
+			metrics.add(CacheMetrics::Misses);
+			recordAccess(AccessTrace::Request, res, 0);
 
-		leastRecentlyUsed.remove(handle);
-		leastRecentlyUsed.push_front(handle);
-	}
+			std::shared_ptr<InFlightLoad>& pending = inFlight[res];
+			if (!pending)
+			{
+				pending = std::make_shared<InFlightLoad>();
+				pending->claimed = true;
+				loadHere = true;
+			}
+			else
+			{
+				++pending->sharers;
+				++coalescedRequests;
+				metrics.add(CacheMetrics::CoalescedWaits);
+			}
+			entry = pending;
+		}
 
-	std::shared_ptr<ResourceHandle> ResourceCache::load(ResId res)
-	{
-		std::shared_ptr<IResourceLoader> loader;
-		std::shared_ptr<ResourceHandle> handle;
+		if (loadHere)
+		{
+			// Dependencies are fetched by the pipeline while this thread loads the root
+			prefetchDependencies(res, false);
+			return loadInFlight(res, entry);
+		}
 
-		for (auto testLoader : resourceLoaders)
+		if (!entry->claimed.exchange(true))
 		{
-			if (testLoader->getPattern() == file->getResourceType(res))
+			// Still queued, loading it here beats waiting for its turn. The
+			// load was already counted when it was queued.
+			try
 			{
-				loader = testLoader;
-				break;
+				handle = load(res);
 			}
+			catch (...)
+			{
+				completeInFlight(res, entry, handle);
+				throw;
+			}
+			completeInFlight(res, entry, handle);
+			return handle;
 		}
 
-		if (!loader && !resourceLoaders.empty())
+		bool ownLoad;
 		{
-			loader = resourceLoaders.back();
+			std::lock_guard<std::mutex> lock(entry->lock);
+			ownLoad = entry->worker == std::this_thread::get_id();
 		}
-
-		if (!loader)
+		if (ownLoad)
 		{
-			throw std::runtime_error("Default resource loader not found!");
+			// Asked for by a loader of something this very load depends on,
+			// further down the stack of this thread. Waiting would never end,
+			// so this copy is read instead, insertLoaded keeps just one.
+			++pipelineCopies;
+			return load(res);
 		}
 
-		uint64_t rawSize = file->getRawResourceSize(res);
-		char* rawCharBuffer = loader->useRawFile() ? allocate(rawSize) : new char[(size_t)rawSize];
+		// Only blocks until this particular resource is done
+		return waitInFlight(entry);
+	}
 
-		if (rawCharBuffer == nullptr)
+	void ResourceCache::preload(ResId res, CompletionCallback completionCallback, void* userData)
+	{
+		if (attachLoad(res, completionCallback, userData, false, false))
 		{
-			// Out of cache memory
-			return std::shared_ptr<ResourceHandle>();
+			prefetchDependencies(res, false);
 		}
+	}
 
-		Buffer rawBuffer(rawCharBuffer, (size_t)rawSize);
+	void ResourceCache::prefetch(ResId res)
+	{
+		if (attachLoad(res, nullptr, nullptr, false, true))
+		{
+			prefetchDependencies(res, true);
+		}
+	}
 
-		file->getRawResource(res, rawBuffer.data());
-		uint64_t size = 0;
+	void ResourceCache::prefetchDependencies(ResId root, bool lowPriority)
+	{
+		std::vector<ResId> closure(getDependencyClosure(root));
 
-		if (loader->useRawFile())
+		for (size_t i = 1; i < closure.size(); ++i)
 		{
-			handle = std::shared_ptr<ResourceHandle>(new ResourceHandle(res, std::move(rawBuffer), this));
+			attachLoad(closure[i], nullptr, nullptr, false, lowPriority);
 		}
-		else
+	}
+
+	std::vector<ResourceCache::ResId> ResourceCache::getDependencyClosure(ResId res) const
+	{
+		std::vector<ResId> closure(1, res);
+		std::set<ResId> seen;
+		seen.insert(res);
+
+		for (size_t i = 0; i < closure.size(); ++i)
 		{
-			size = loader->getLoadedResourceSize(rawBuffer);
-			Buffer buffer(allocate(size), (size_t)size);
-			if (rawBuffer.data() == nullptr || buffer.data() == nullptr)
+			std::vector<ResId> deps(file->getResourceDependencies(closure[i]));
+			for (ResId dep : deps)
 			{
-				// Out of cache memory
-				return std::shared_ptr<ResourceHandle>();
+				if (seen.insert(dep).second)
+				{
+					closure.push_back(dep);
+				}
 			}
-			handle = std::shared_ptr<ResourceHandle>(new ResourceHandle(res, std::move(buffer), this));
+		}
+
+		return closure;
+	}
+
+	uint64_t ResourceCache::getResourceSize(ResId res) const
+	{
+		return file->getRawResourceSize(res);
+	}
+
+	bool ResourceCache::attachLoad(ResId res, CompletionCallback completionCallback, void* userData, bool notifyFailure, bool lowPriority)
+	{
+		bool started = false;
+
+		std::shared_ptr<ResourceHandle> handle(find(res));
+
+		if (!handle)
+		{
+			std::unique_ptr<LoadJob> job;
+			std::shared_ptr<InFlightLoad> entry;
 
-			if (!loader->loadResource(rawBuffer, handle))
 			{
-				// Out of cache memory
-				return std::shared_ptr<ResourceHandle>();
+				std::lock_guard<std::mutex> lock(inFlightLock);
+
+				handle = find(res);
+				if (!handle)
+				{
+					++tiers[MemoryTier].misses;
+					metrics.add(CacheMetrics::Misses);
+					recordAccess(AccessTrace::Preload, res, 0);
+
+					auto pending = inFlight.find(res);
+					if (pending != inFlight.end())
+					{
+						entry = pending->second;
+
+						if (entry->lowPriority && !lowPriority && !entry->claimed)
+						{
+							// Queue it again up front, whichever copy of the
+							// job is picked first claims the load
+							entry->lowPriority = false;
+							job.reset(new LoadJob());
+							job->res = res;
+							job->loader = findLoader(res);
+							job->entry = entry;
+						}
+
+						if (completionCallback)
+						{
+							++entry->sharers;
+							++coalescedRequests;
+							metrics.add(CacheMetrics::CoalescedWaits);
+						}
+					}
+					else
+					{
+						job.reset(new LoadJob());
+						job->res = res;
+						job->loader = findLoader(res);
+						job->entry = entry = std::make_shared<InFlightLoad>();
+						entry->lowPriority = lowPriority;
+						inFlight[res] = entry;
+						++numLoads;
+						started = true;
+					}
+
+					if (completionCallback)
+					{
+						LoadCallback callback = { completionCallback, userData, notifyFailure };
+
+						std::lock_guard<std::mutex> entryLock(entry->lock);
+						entry->callbacks.push_back(callback);
+					}
+				}
 			}
-		}
 
-		if (handle)
-		{
-			std::unique_lock<std::recursive_mutex> lLock(leastRecentlyUsedLock, std::defer_lock);
-			std::unique_lock<std::recursive_mutex> rLock(resourcesLock, std::defer_lock);
-			std::lock(lLock, rLock);
+			if (job && !stages[IoStage].queue.push(std::move(job), !lowPriority))
+			{
+				// Shutting down
+				completeInFlight(res, entry, std::shared_ptr<ResourceHandle>());
+			}
 
-			leastRecentlyUsed.push_front(handle);
-			resources[res] = handle;
+			if (!handle)
+			{
+				return started;
+			}
 		}
 
-		return handle;
-	}
+		++tiers[MemoryTier].hits;
+		metrics.add(CacheMetrics::Hits);
+		recordAccess(AccessTrace::Preload, res, handle->getChargedSize());
 
-	void ResourceCache::asyncLoad(ResId res, void (*completionCallback)(std::shared_ptr<ResourceHandle>, void*), void* userData)
-	{
-		std::shared_ptr<ResourceHandle> handle = load(res);
-		if (handle)
+		if (completionCallback)
 		{
 			completionCallback(handle, userData);
 		}
-		
-		std::thread me;
-		{
-			std::lock_guard<std::recursive_mutex> rLock(workerLock);
-			me = std::move(workers[res]);
-			workers.erase(res);
-		}
 
-		std::lock_guard<std::mutex> lock(doneWorkersLock);
-		doneWorkers.push_back(std::move(me));
+		return false;
 	}
 
-	void ResourceCache::free(std::shared_ptr<ResourceHandle> gonner)
+	void ResourceCache::defineSet(const std::string& name, const std::vector<ResId>& members)
 	{
-		std::unique_lock<std::recursive_mutex> lLock(leastRecentlyUsedLock, std::defer_lock);
-		std::unique_lock<std::recursive_mutex> rLock(resourcesLock, std::defer_lock);
-		std::lock(lLock, rLock);
-
-		resources.erase(gonner->resource);
-		leastRecentlyUsed.remove(gonner);
+		std::vector<ResId> uniqueMembers(members);
+		std::sort(uniqueMembers.begin(), uniqueMembers.end());
+		uniqueMembers.erase(std::unique(uniqueMembers.begin(), uniqueMembers.end()), uniqueMembers.end());
 
-		std::weak_ptr<ResourceHandle> weakGonner = gonner;
-		gonner.reset();
-		gonner = weakGonner.lock();
+		std::lock_guard<std::mutex> lock(setLock);
 
-		if (gonner)
+		auto iter = sets.find(name);
+		if (iter != sets.end() && iter->second.loadCount > 0)
 		{
-			weakResources[gonner->resource] = gonner;
+			throw std::runtime_error("Resource set " + name + " can not be redefined while loaded");
 		}
+
+		ResourceSet& set = sets[name];
+		set.members.swap(uniqueMembers);
+		set.loadCount = 0;
 	}
 
-	void ResourceCache::makeRoom(uint64_t size)
+	void ResourceCache::defineSetFrom(const std::string& name, ResId source, SetExtractor extractor)
 	{
-		if (size > cacheSize)
+		std::shared_ptr<ResourceHandle> handle = getHandle(source);
+		if (!handle)
 		{
-			throw std::runtime_error("Object to large for cache");
+			throw std::runtime_error("Resource set " + name + " could not load " + findPath(source));
 		}
 
-		while (size > cacheSize - allocated)
+		std::vector<ResId> members(1, source);
+		extractor(*handle, members);
+
+		defineSet(name, members);
+	}
+
+	void ResourceCache::loadSet(const std::string& name, SetCallback callback, void* userData, bool lowPriority)
+	{
+		std::vector<ResId> members;
 		{
-			if (leastRecentlyUsed.empty())
-			{
-				std::streamsize oldWidth = std::cerr.width();
-				std::streamsize idWidth = std::numeric_limits<ResId>::digits10 + 1;
-				std::streamsize sizeWidth = std::numeric_limits<size_t>::digits10 + 1;
+			std::lock_guard<std::mutex> lock(setLock);
 
-				std::cerr << "Failed to make room for resource\n";
-				std::cerr << "\nResources currently loaded:\n";
-				for (const auto& res : weakResources)
-				{
-					std::shared_ptr<ResourceHandle> handle = res.second.lock();
-					if (handle)
-					{
-						std::cerr << std::setw(idWidth) << res.first << " "
-							<< std::setw(sizeWidth) << handle->getBuffer().size() << std::setw(oldWidth) << " B "
-							<< file->getResourceName(res.first) << "\n";
-					}
-				}
-				std::cerr << std::endl;
-				break;
+			auto iter = sets.find(name);
+			if (iter == sets.end())
+			{
+				throw std::runtime_error("Unknown resource set " + name);
 			}
 
-			freeOneResource();
+			++iter->second.loadCount;
+			members = iter->second.members;
 		}
-	}
 
-	char* ResourceCache::allocate(uint64_t size)
-	{
-		std::unique_lock<std::recursive_mutex> lLock(leastRecentlyUsedLock, std::defer_lock);
-		std::unique_lock<std::recursive_mutex> rLock(resourcesLock, std::defer_lock);
-		std::lock(lLock, rLock);
+		// Pin first so that nothing is evicted while the rest is loading
+		for (ResId res : members)
+		{
+			pin(res);
+		}
 
-		makeRoom(size);
+		SetLoad* setLoad = new SetLoad();
+		setLoad->name = name;
+		setLoad->remaining = members.size() + 1;
+		setLoad->failed = false;
+		setLoad->callback = callback;
+		setLoad->userData = userData;
 
-		char* mem = new char[(size_t)size];
-		if (mem)
+		for (ResId res : members)
 		{
-			uint64_t alloced = allocated += size;
-			if (alloced > maxAllocated)
+			if (attachLoad(res, &setMemberLoaded, setLoad, true, lowPriority))
 			{
-				maxAllocated = alloced;
+				prefetchDependencies(res, lowPriority);
 			}
 		}
 
-		return mem;
+		// Drops the extra count that kept the set from finishing while members were still being attached
+		finishSetMember(setLoad, true);
 	}
 
-	void ResourceCache::freeOneResource()
+	void ResourceCache::releaseSet(const std::string& name)
 	{
-		std::shared_ptr<ResourceHandle> handle = leastRecentlyUsed.back();
-		leastRecentlyUsed.pop_back();
+		std::vector<ResId> members;
+		{
+			std::lock_guard<std::mutex> lock(setLock);
 
-		resources.erase(handle->resource);
-		leastRecentlyUsed.remove(handle);
+			auto iter = sets.find(name);
+			if (iter == sets.end() || iter->second.loadCount == 0)
+			{
+				throw std::runtime_error("Resource set " + name + " is not loaded");
+			}
 
-		std::weak_ptr<ResourceHandle> weakGonner = handle;
-		handle.reset();
-		handle = weakGonner.lock();
+			--iter->second.loadCount;
+			members = iter->second.members;
+		}
 
-		if (handle)
+		for (ResId res : members)
 		{
-			weakResources[handle->resource] = handle;
+			unpin(res);
 		}
 	}
 
-	void ResourceCache::memoryHasBeenFreed(uint64_t size, ResId resId)
+	ResourceCache::ResId ResourceCache::findByPath(const std::string& path) const
 	{
-		std::unique_lock<std::recursive_mutex> lLock(leastRecentlyUsedLock, std::defer_lock);
-		std::unique_lock<std::recursive_mutex> rLock(resourcesLock, std::defer_lock);
-		std::lock(lLock, rLock);
-
-		allocated -= size;
-		if (weakResources.count(resId) > 0)
+		ResId resId;
+		if (!file->findResource(path, resId))
 		{
-			weakResources.erase(resId);
+			throw std::runtime_error(path + " could not be mapped to a resource");
 		}
+
+		return resId;
 	}
 
-	ResourceCache::ResourceCache(uint64_t sizeInMiB, std::unique_ptr<IResourceFile>&& resFile)
-		: cacheSize(sizeInMiB * 1024 * 1024),
-		allocated(0),
-		maxAllocated(0),
-		file(std::move(resFile))
+	std::string ResourceCache::findPath(ResId res) const
 	{
+		return file->getResourceName(res);
 	}
 
-	ResourceCache::~ResourceCache()
+	size_t ResourceCache::reloadFile()
 	{
-		for (auto& t : workers)
+		// One reload at a time, a second one waits and picks up whatever the first missed
+		std::lock_guard<std::mutex> lock(reloadLock);
+
+		cl::time_point startTime = cl::now();
+
 		{
-			t.second.join();
+			std::unique_lock<std::mutex> leaseLock(fileLeaseLock);
+			fileReloading = true;
+			while (fileLeases > 0)
+			{
+				fileLeasesChanged.wait(leaseLock);
+			}
+			fileSwapping = true;
 		}
-		workers.clear();
 
-		for (auto& t : doneWorkers)
+		std::vector<ResId> changed;
+		try
+		{
+			if (!file->reload(changed))
+			{
+				throw std::runtime_error("The resource file can not be reloaded");
+			}
+
+			// Loads read before this are turned away once they finish
+			if (!changed.empty())
+			{
+				++fileGeneration;
+			}
+
+			// Before any new load gets to put the new version in
+			for (ResId res : changed)
+			{
+				invalidate(res);
+			}
+		}
+		catch (...)
 		{
-			t.join();
+			{
+				std::lock_guard<std::mutex> leaseLock(fileLeaseLock);
+				fileReloading = false;
+				fileSwapping = false;
+			}
+			fileLeasesChanged.notify_all();
+
+			++failedReloads;
+			GENA_TRACE(Trace::Error, Trace::ReloadFailed, 0, 0);
+			throw;
 		}
-		doneWorkers.clear();
 
-		while (!leastRecentlyUsed.empty())
 		{
-			freeOneResource();
+			std::lock_guard<std::mutex> leaseLock(fileLeaseLock);
+			fileReloading = false;
+			fileSwapping = false;
 		}
-	}
+		fileLeasesChanged.notify_all();
 
-	void ResourceCache::init()
-	{
-		file->open();
-		registerLoader(std::shared_ptr<IResourceLoader>(new DefaultResourceLoader()));
-	}
+		uint64_t reloadUs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - startTime).count();
+		++numReloads;
+		reloadedResources += changed.size();
+		lastReloadUs = reloadUs;
+		if (reloadUs > maxReloadUs)
+		{
+			maxReloadUs = reloadUs;
+		}
 
-	void ResourceCache::registerLoader(std::shared_ptr<IResourceLoader> loader)
-	{
-		resourceLoaders.push_front(loader);
+		return changed.size();
 	}
 
-	std::shared_ptr<ResourceHandle> ResourceCache::getHandle(ResId res)
+	void ResourceCache::fileChanged(void* userData)
 	{
-		std::unique_lock<std::recursive_mutex> lock(workerLock);
+		ResourceCache* cache = static_cast<ResourceCache*>(userData);
 
-		std::shared_ptr<ResourceHandle> handle(find(res));
-		if (!handle)
+		try
 		{
-			if (workers.count(res) == 0)
-			{
-				handle = load(res);
-			}
-			else
-			{
-				workers[res].join();
-				workers.erase(res);
-				handle = find(res);
-			}
+			cache->reloadFile();
 		}
-		else
+		catch (std::exception&)
 		{
-			update(handle);
+			// Likely caught halfway through being written, the next change
+			// reloads it again. Counted in the reload stats.
 		}
-
-		return handle;
 	}
 
-	void ResourceCache::preload(ResId res, void (*completionCallback)(std::shared_ptr<ResourceHandle>, void*), void* userData)
+	void ResourceCache::setHotReload(bool enabled)
 	{
-		std::shared_ptr<ResourceHandle> handle;
-
+		if (!enabled)
 		{
-			std::unique_lock<std::recursive_mutex> lock(workerLock);
+			watcher.reset();
+			return;
+		}
 
-			handle = find(res);
-			if (!handle)
-			{
-				if (workers.count(res) == 0)
-				{
-					std::thread newWorker(&ResourceCache::asyncLoad, this, res, completionCallback, userData);
-					workers.emplace(res, std::move(newWorker));
-				}
+		if (watcher)
+		{
+			return;
+		}
 
-				return;
-			}
+		const std::string path = file->getFilePath();
+		if (path.empty())
+		{
+			throw std::runtime_error("The resource file has no path to watch");
 		}
 
-		completionCallback(handle, userData);
+		watcher.reset(new FileWatcher(path, &fileChanged, this));
+	}
 
-		std::lock_guard<std::mutex> lock(doneWorkersLock);
-		for (auto& doneThread : doneWorkers)
+	static std::string tracedResourceName(Trace::ResId res, void* userData)
+	{
+		try
+		{
+			return ((const ResourceCache*)userData)->findPath(res);
+		}
+		catch (std::exception&)
 		{
-			doneThread.join();
+			// Removed by a reload since, or not a resource at all
+			std::ostringstream name;
+			name << std::hex << res;
+			return name.str();
 		}
-		doneWorkers.clear();
 	}
 
-	ResourceCache::ResId ResourceCache::findByPath(const std::string path) const
+	void ResourceCache::recordAccess(AccessTrace::EventType type, ResId res, uint64_t size)
 	{
-		const uint32_t numRes = file->getNumResources();
-		for (uint32_t i = 0; i < numRes; ++i)
+		if (accessTrace.isRecording())
 		{
-			ResId resId = file->getResourceId(i);
-			if (file->getResourceName(resId) == path)
-			{
-				return resId;
-			}
+			accessTrace.record(type, res, size);
 		}
+	}
 
-		throw std::runtime_error(path + " could not be mapped to a resource");
+	void ResourceCache::startAccessTrace(const std::string& path)
+	{
+		accessTrace.open(path);
 	}
 
-	std::string ResourceCache::findPath(ResId res) const
+	void ResourceCache::stopAccessTrace()
 	{
-		return file->getResourceName(res);
+		accessTrace.close();
+	}
+
+	CacheMetrics::Snapshot ResourceCache::getMetrics() const
+	{
+		return metrics.getSnapshot();
+	}
+
+	void ResourceCache::resetMetrics()
+	{
+		metrics.reset();
+	}
+
+	void ResourceCache::exportTrace(const std::string& path) const
+	{
+		Trace::exportChromeTrace(path, &tracedResourceName, (void*)this);
 	}
 
 	uint64_t ResourceCache::getMaxMemAllocated() const
 	{
 		return maxAllocated;
 	}
+
+	ResourceCache::LoadStats ResourceCache::getLoadStats() const
+	{
+		LoadStats stats;
+		stats.loads = numLoads;
+		stats.coalescedRequests = coalescedRequests;
+		stats.duplicateBytesSaved = duplicateBytesSaved;
+		stats.pipelineCopies = pipelineCopies;
+		stats.currentWaiters = currentWaiters;
+		stats.maxWaiters = maxWaiters;
+
+		return stats;
+	}
+
+	ResourceCache::StageStats ResourceCache::getStageStats(PipelineStage stage) const
+	{
+		const Stage& current = stages[stage];
+
+		StageStats stats;
+		stats.threads = current.numThreads;
+		stats.jobs = current.queue.getNumPopped();
+		stats.queueDepth = current.queue.getDepth();
+		stats.maxQueueDepth = current.queue.getMaxDepth();
+
+		double waitMs = std::chrono::duration_cast<std::chrono::microseconds>(current.queue.getTotalWait()).count() / 1000.0;
+		double workMs = current.workTimeUs / 1000.0;
+		stats.avgWaitMs = stats.jobs > 0 ? waitMs / stats.jobs : 0.0;
+		stats.avgWorkMs = stats.jobs > 0 ? workMs / stats.jobs : 0.0;
+
+		return stats;
+	}
+
+	ResourceCache::TierStats ResourceCache::getTierStats(CacheTier tier) const
+	{
+		const TierCounters& counters = tiers[tier];
+
+		TierStats stats;
+		stats.hits = counters.hits;
+		stats.misses = counters.misses;
+		stats.hitRate = stats.hits + stats.misses > 0 ? (double)stats.hits / (stats.hits + stats.misses) : 0.0;
+		stats.avgLatencyMs = stats.hits > 0 ? counters.timeUs / 1000.0 / stats.hits : 0.0;
+
+		switch (tier)
+		{
+		case MemoryTier:
+			stats.bytesUsed = allocated;
+			stats.budget = cacheSize;
+			break;
+
+		case CompressedTier:
+			stats.bytesUsed = compressed.getStats().compressedBytes;
+			stats.budget = compressed.getBudget();
+			break;
+
+		default:
+			stats.bytesUsed = 0;
+			stats.budget = 0;
+			break;
+		}
+
+		return stats;
+	}
+
+	CompressedStore::Stats ResourceCache::getCompressedStats() const
+	{
+		return compressed.getStats();
+	}
+
+	DecodedDiskCache::Stats ResourceCache::getDecodedCacheStats() const
+	{
+		return diskCache.getStats();
+	}
+
+	ResourceCache::PressureStats ResourceCache::getPressureStats() const
+	{
+		PressureStats stats;
+		stats.level = (PressureLevel)pressureLevel.load();
+		stats.evictionBatches = evictionBatches;
+		stats.evicted = numEvicted;
+		stats.backgroundBatches = backgroundBatches;
+		stats.backgroundEvicted = backgroundEvicted;
+		stats.overcommits = numOvercommits;
+		stats.rejected = numRejected;
+		stats.waits = numRoomWaits;
+		stats.totalWaitMs = roomWaitUs / 1000.0;
+
+		return stats;
+	}
+
+	ResourceCache::FreeStats ResourceCache::getFreeStats() const
+	{
+		FreeStats stats;
+		stats.freed = numFreed;
+		stats.batches = freeBatches;
+		stats.lastBatchMs = lastFreeBatchUs / 1000.0;
+		stats.maxBatchMs = maxFreeBatchUs / 1000.0;
+		stats.totalMs = totalFreeUs / 1000.0;
+
+		return stats;
+	}
+
+	ResourceCache::ReloadStats ResourceCache::getReloadStats() const
+	{
+		ReloadStats stats;
+		stats.reloads = numReloads;
+		stats.failedReloads = failedReloads;
+		stats.changedResources = reloadedResources;
+		stats.lastReloadMs = lastReloadUs / 1000.0;
+		stats.maxReloadMs = maxReloadUs / 1000.0;
+
+		return stats;
+	}
+
+	ResourceCache::ScratchStats ResourceCache::getScratchStats()
+	{
+		ScratchStats stats;
+		{
+			std::lock_guard<std::mutex> lock(scratchLock);
+			stats.limit = scratchLimit;
+			stats.current = scratchBytes;
+		}
+		stats.peak = scratchPeak;
+		stats.peakTotal = scratchPeakTotal;
+		stats.admissionWaits = admissionWaits;
+		stats.totalWaitMs = admissionWaitUs / 1000.0;
+
+		return stats;
+	}
 }
@@ -1,25 +1,43 @@
 #include "ResourceHandle.h"
 
 #include "ResourceCache.h"
-
-#include <iostream>
+#include "Trace.h"
 
 namespace GENA
 {
 	ResourceHandle::ResourceHandle(ResId resId, Buffer&& buffer, ResourceCache* resCache)
 		: resource(resId),
 		buffer(std::move(buffer)),
-		resCache(resCache)
+		resCache(resCache),
+		stale(false),
+		nextDead(nullptr)
+	{
+		GENA_TRACE(Trace::Verbose, Trace::HandleCreated, resource, this->buffer.size());
+	}
+
+	ResourceHandle::ResourceHandle(ResId resId, Buffer&& buffer, ResourceCache* resCache, std::shared_ptr<const void> mapping)
+		: resource(resId),
+		buffer(std::move(buffer)),
+		resCache(resCache),
+		mapping(mapping),
+		stale(false),
+		nextDead(nullptr)
 	{
-		std::cout << "Resource created: " << resCache->findPath(resource) << std::endl;
+		GENA_TRACE(Trace::Verbose, Trace::HandleMapped, resource, this->buffer.size());
 	}
 
 	ResourceHandle::~ResourceHandle()
 	{
-		size_t memSize = buffer.size();
+		uint64_t memSize = getChargedSize();
+		resCache->handleDestroyed(*this);
 		buffer.clear();
 		resCache->memoryHasBeenFreed(memSize, resource);
-		std::cerr << "Resource released: " << resCache->findPath(resource) << std::endl;
+		GENA_TRACE(Trace::Verbose, Trace::HandleReleased, resource, memSize);
+	}
+
+	ResourceHandle::ResId ResourceHandle::getId() const
+	{
+		return resource;
 	}
 
 	Buffer& ResourceHandle::getBuffer()
@@ -31,4 +49,14 @@ namespace GENA
 	{
 		return buffer;
 	}
+
+	uint64_t ResourceHandle::getChargedSize() const
+	{
+		return buffer.isView() ? 0 : buffer.size();
+	}
+
+	bool ResourceHandle::isStale() const
+	{
+		return stale;
+	}
 }
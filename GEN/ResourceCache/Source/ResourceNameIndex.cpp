@@ -0,0 +1,69 @@
+#include "ResourceNameIndex.h"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace GENA
+{
+	void ResourceNameIndex::set(ResId res, const std::string& name)
+	{
+		auto iter = names.find(res);
+		if (iter != names.end() && *iter->second == name)
+		{
+			return;
+		}
+
+		auto taken = ids.find(name);
+		if (taken != ids.end())
+		{
+			throw std::runtime_error("Resource name " + name + " is used more than once");
+		}
+
+		remove(res);
+
+		auto inserted = ids.insert(std::make_pair(name, res));
+		names[res] = &inserted.first->first;
+	}
+
+	void ResourceNameIndex::remove(ResId res)
+	{
+		auto iter = names.find(res);
+		if (iter == names.end())
+		{
+			return;
+		}
+
+		ids.erase(*iter->second);
+		names.erase(iter);
+	}
+
+	bool ResourceNameIndex::find(const std::string& name, ResId& res) const
+	{
+		auto iter = ids.find(name);
+		if (iter == ids.end())
+		{
+			return false;
+		}
+
+		res = iter->second;
+		return true;
+	}
+
+	const std::string& ResourceNameIndex::getName(ResId res) const
+	{
+		auto iter = names.find(res);
+		if (iter == names.end())
+		{
+			std::ostringstream msg;
+			msg << "No resource with id " << std::hex << res;
+			throw std::runtime_error(msg.str());
+		}
+
+		return *iter->second;
+	}
+
+	size_t ResourceNameIndex::size() const
+	{
+		return ids.size();
+	}
+}
@@ -0,0 +1,157 @@
+#include "RoomPrefetcher.h"
+
+#include <cmath>
+
+namespace GENA
+{
+	RoomPrefetcher::RoomPrefetcher(ResourceCache& cache, float roomSize, RoomResolver resolver, void* userData)
+		: cache(cache),
+		roomSize(roomSize),
+		resolver(resolver),
+		resolverData(userData),
+		lookahead(2),
+		horizon(5.f),
+		memoryBudget(cache.getTierStats(ResourceCache::MemoryTier).budget / 2)
+	{
+		stats.roomsPrefetched = 0;
+		stats.roomsReleased = 0;
+		stats.bytesRequested = 0;
+		stats.roomsHeld = 0;
+	}
+
+	RoomPrefetcher::~RoomPrefetcher()
+	{
+		clear();
+	}
+
+	void RoomPrefetcher::setLookahead(unsigned int rooms)
+	{
+		lookahead = rooms;
+	}
+
+	void RoomPrefetcher::setHorizon(float seconds)
+	{
+		horizon = seconds;
+	}
+
+	void RoomPrefetcher::setMemoryBudget(uint64_t bytes)
+	{
+		memoryBudget = bytes;
+	}
+
+	void RoomPrefetcher::update(float position, float velocity)
+	{
+		for (auto& room : held)
+		{
+			room.second = false;
+		}
+
+		int currentRoom = (int)std::floor(position / roomSize);
+		float speed = std::abs(velocity);
+		int step = velocity < 0.f ? -1 : 1;
+		uint64_t usedBytes = 0;
+
+		if (speed > 0.f)
+		{
+			for (unsigned int i = 1; i <= lookahead; ++i)
+			{
+				int roomNr = currentRoom + step * (int)i;
+
+				// Distance to the near edge of the room
+				float edge = step > 0 ? roomNr * roomSize : (roomNr + 1) * roomSize;
+				float timeToReach = std::abs(edge - position) / speed;
+				if (timeToReach > horizon)
+				{
+					break;
+				}
+
+				uint64_t size = measureRoom(roomNr);
+				if (memoryBudget != 0 && size > memoryBudget - usedBytes)
+				{
+					// Rooms further away would not fit either
+					break;
+				}
+				usedBytes += size;
+
+				auto room = held.find(roomNr);
+				if (room == held.end())
+				{
+					holdRoom(roomNr);
+				}
+				else
+				{
+					room->second = true;
+				}
+			}
+		}
+
+		for (auto room = held.begin(); room != held.end(); )
+		{
+			if (room->second)
+			{
+				++room;
+			}
+			else
+			{
+				releaseRoom(room++);
+			}
+		}
+
+		stats.roomsHeld = held.size();
+	}
+
+	void RoomPrefetcher::clear()
+	{
+		while (!held.empty())
+		{
+			releaseRoom(held.begin());
+		}
+		stats.roomsHeld = 0;
+	}
+
+	RoomPrefetcher::Stats RoomPrefetcher::getStats() const
+	{
+		return stats;
+	}
+
+	uint64_t RoomPrefetcher::measureRoom(int roomNr)
+	{
+		auto known = roomSizes.find(roomNr);
+		if (known != roomSizes.end())
+		{
+			return known->second;
+		}
+
+		std::vector<ResId>& closure = closures[roomNr];
+		closure = cache.getDependencyClosure(resolver(roomNr, resolverData));
+
+		uint64_t size = 0;
+		for (ResId res : closure)
+		{
+			size += cache.getResourceSize(res);
+		}
+
+		roomSizes[roomNr] = size;
+		return size;
+	}
+
+	void RoomPrefetcher::holdRoom(int roomNr)
+	{
+		// Every member on its own, some may still be cached from before
+		for (ResId res : closures[roomNr])
+		{
+			cache.prefetch(res);
+		}
+		held[roomNr] = true;
+
+		++stats.roomsPrefetched;
+		stats.bytesRequested += roomSizes[roomNr];
+	}
+
+	void RoomPrefetcher::releaseRoom(std::map<int, bool>::iterator room)
+	{
+		// Nothing is pinned, what was loaded is left for eviction to judge
+		held.erase(room);
+		++stats.roomsReleased;
+	}
+}
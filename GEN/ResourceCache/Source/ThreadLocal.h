@@ -0,0 +1,11 @@
+#pragma once
+
+/**
+ * Thread local storage for plain data. Visual Studio 2012 has no
+ * thread_local.
+ */
+#ifdef _MSC_VER
+#define GENA_THREAD_LOCAL __declspec(thread)
+#else
+#define GENA_THREAD_LOCAL __thread
+#endif
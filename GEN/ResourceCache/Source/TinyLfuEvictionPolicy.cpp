@@ -0,0 +1,176 @@
+#include "TinyLfuEvictionPolicy.h"
+
+#include <algorithm>
+
+namespace GENA
+{
+	TinyLfuEvictionPolicy::FrequencySketch::FrequencySketch()
+		: counters(numRows * rowSize, 0),
+		additions(0)
+	{
+	}
+
+	uint32_t TinyLfuEvictionPolicy::FrequencySketch::index(ResId res, unsigned int row) const
+	{
+		static const uint32_t seeds[numRows] = { 0x9e3779b9u, 0x85ebca6bu, 0xc2b2ae35u, 0x27d4eb2fu };
+
+		uint32_t hash = (res ^ seeds[row]) * 0x01000193u;
+		hash ^= hash >> 15;
+		hash *= seeds[(row + 1) % numRows];
+		hash ^= hash >> 13;
+
+		return row * rowSize + (hash & (rowSize - 1));
+	}
+
+	void TinyLfuEvictionPolicy::FrequencySketch::increment(ResId res)
+	{
+		for (unsigned int row = 0; row < numRows; ++row)
+		{
+			uint8_t& counter = counters[index(res, row)];
+			if (counter < 15)
+			{
+				++counter;
+			}
+		}
+
+		// Reset after a sample of 10 times the counters per row, halving all counters
+		if (++additions >= rowSize * 10)
+		{
+			additions = 0;
+			for (uint8_t& counter : counters)
+			{
+				counter >>= 1;
+			}
+		}
+	}
+
+	unsigned int TinyLfuEvictionPolicy::FrequencySketch::frequency(ResId res) const
+	{
+		unsigned int freq = 15;
+		for (unsigned int row = 0; row < numRows; ++row)
+		{
+			freq = std::min<unsigned int>(freq, counters[index(res, row)]);
+		}
+		return freq;
+	}
+
+	TinyLfuEvictionPolicy::TinyLfuEvictionPolicy()
+		: capacity(0)
+	{
+	}
+
+	std::unique_ptr<IEvictionPolicy> TinyLfuEvictionPolicy::create()
+	{
+		return std::unique_ptr<IEvictionPolicy>(new TinyLfuEvictionPolicy());
+	}
+
+	std::string TinyLfuEvictionPolicy::getName() const
+	{
+		return "W-TinyLFU";
+	}
+
+	void TinyLfuEvictionPolicy::setCapacity(uint64_t bytes)
+	{
+		capacity = bytes;
+	}
+
+	void TinyLfuEvictionPolicy::inserted(ResId res, uint64_t size)
+	{
+		removed(res);
+
+		sketch.increment(res);
+		window.pushFront(res, size);
+	}
+
+	void TinyLfuEvictionPolicy::accessed(ResId res)
+	{
+		sketch.increment(res);
+
+		if (window.contains(res))
+		{
+			window.moveToFront(res);
+		}
+		else if (probation.contains(res))
+		{
+			uint64_t size = probation.sizeOf(res);
+			probation.remove(res);
+			protectedSegment.pushFront(res, size);
+
+			// The protected segment may use 80% of the main region
+			const uint64_t maxProtected = (capacity - capacity / 100) / 5 * 4;
+			while (protectedSegment.getBytes() > maxProtected && !protectedSegment.empty())
+			{
+				ResId demoted = protectedSegment.popBack(size);
+				probation.pushFront(demoted, size);
+			}
+		}
+		else if (protectedSegment.contains(res))
+		{
+			protectedSegment.moveToFront(res);
+		}
+	}
+
+	void TinyLfuEvictionPolicy::removed(ResId res)
+	{
+		if (!window.remove(res) && !probation.remove(res))
+		{
+			protectedSegment.remove(res);
+		}
+
+		candidates.erase(std::remove(candidates.begin(), candidates.end(), res), candidates.end());
+	}
+
+	bool TinyLfuEvictionPolicy::empty() const
+	{
+		return window.empty() && probation.empty() && protectedSegment.empty();
+	}
+
+	IEvictionPolicy::ResId TinyLfuEvictionPolicy::selectVictim()
+	{
+		uint64_t size;
+
+		// Move window overflow into the main region as admission candidates,
+		// the window holding 1% of the cache
+		const uint64_t maxWindow = std::max<uint64_t>(1, capacity / 100);
+		while (window.getBytes() > maxWindow && !window.empty())
+		{
+			ResId candidate = window.popBack(size);
+			probation.pushFront(candidate, size);
+			candidates.push_back(candidate);
+		}
+
+		if (probation.empty() && protectedSegment.empty())
+		{
+			return window.popBack(size);
+		}
+
+		if (probation.empty())
+		{
+			ResId demoted = protectedSegment.popBack(size);
+			probation.pushFront(demoted, size);
+		}
+
+		ResId victim = probation.back();
+
+		// Let the oldest pending candidate duel the main region's victim
+		while (!candidates.empty())
+		{
+			ResId candidate = candidates.front();
+			candidates.erase(candidates.begin());
+
+			if (candidate == victim || !probation.contains(candidate))
+			{
+				continue;
+			}
+
+			if (sketch.frequency(candidate) <= sketch.frequency(victim))
+			{
+				probation.remove(candidate);
+				return candidate;
+			}
+			break;
+		}
+
+		return probation.popBack(size);
+	}
+}
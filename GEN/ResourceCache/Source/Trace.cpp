@@ -0,0 +1,305 @@
+#include "Trace.h"
+
+#include "ThreadLocal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace GENA
+{
+	typedef std::chrono::high_resolution_clock cl;
+
+	/**
+	 * Events of one thread. Only the owning thread writes events and
+	 * moves head, readers check head again after copying to find out
+	 * which of the events they copied might have been overwritten. The
+	 * events are allocated on the first one recorded, so naming a thread
+	 * costs next to nothing while tracing is off.
+	 */
+	struct ThreadBuffer
+	{
+		std::unique_ptr<Trace::Event[]> events;
+		size_t capacity;
+		std::atomic<uint64_t> head;
+		std::atomic<uint64_t> start;
+		uint32_t tid;
+		std::string name;
+
+		ThreadBuffer()
+			: capacity(0),
+			head(0),
+			start(0),
+			tid(0)
+		{
+		}
+	};
+
+	static const char* const eventNames[Trace::NumEventTypes] =
+	{
+		"Load begin",
+		"Load end",
+		"Load failed",
+		"Hit",
+		"Miss",
+		"Evict",
+		"Handle created",
+		"Handle mapped",
+		"Handle released",
+		"Graphics upload",
+		"Graphics remove",
+		"Reload failed"
+	};
+
+	static const cl::time_point epoch = cl::now();
+
+	static std::mutex registryLock;
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	static std::atomic<size_t> bufferSize(64 * 1024);
+
+	static GENA_THREAD_LOCAL ThreadBuffer* threadBuffer = nullptr;
+
+	static ThreadBuffer* getThreadBuffer()
+	{
+		if (!threadBuffer)
+		{
+			std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+
+			std::lock_guard<std::mutex> lock(registryLock);
+			buffer->tid = (uint32_t)buffers.size() + 1;
+			threadBuffer = buffer.get();
+			buffers.push_back(std::move(buffer));
+		}
+
+		return threadBuffer;
+	}
+
+	static std::string escape(const std::string& str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				escaped.push_back('\\');
+				escaped.push_back(c);
+			}
+			else if ((unsigned char)c >= 0x20)
+			{
+				escaped.push_back(c);
+			}
+		}
+
+		return escaped;
+	}
+
+	std::atomic<int> Trace::level(Trace::Off);
+
+	void Trace::setLevel(Level newLevel)
+	{
+		level = newLevel;
+	}
+
+	Trace::Level Trace::getLevel()
+	{
+		return (Level)level.load();
+	}
+
+	void Trace::setBufferSize(size_t events)
+	{
+		if (events == 0)
+		{
+			throw std::runtime_error("Trace buffers need room for at least one event");
+		}
+
+		bufferSize = events;
+	}
+
+	void Trace::setThreadName(const std::string& name)
+	{
+		ThreadBuffer* buffer = getThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(registryLock);
+		buffer->name = name;
+	}
+
+	void Trace::record(EventType type, ResId res, uint64_t value)
+	{
+		ThreadBuffer* buffer = getThreadBuffer();
+		if (buffer->capacity == 0)
+		{
+			std::lock_guard<std::mutex> lock(registryLock);
+			const size_t size = bufferSize;
+			buffer->events.reset(new Event[size]);
+			buffer->capacity = size;
+		}
+
+		uint64_t pos = buffer->head.load(std::memory_order_relaxed);
+		Event& event = buffer->events[pos % buffer->capacity];
+		event.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(cl::now() - epoch).count();
+		event.value = value;
+		event.res = res;
+		event.type = type;
+
+		buffer->head.store(pos + 1, std::memory_order_release);
+	}
+
+	void Trace::clear()
+	{
+		std::lock_guard<std::mutex> lock(registryLock);
+
+		for (auto& buffer : buffers)
+		{
+			buffer->start = buffer->head.load();
+		}
+	}
+
+	Trace::Stats Trace::getStats()
+	{
+		std::lock_guard<std::mutex> lock(registryLock);
+
+		Stats stats;
+		stats.recorded = 0;
+		stats.overwritten = 0;
+		stats.threads = buffers.size();
+
+		for (auto& buffer : buffers)
+		{
+			uint64_t count = buffer->head - buffer->start;
+			stats.recorded += count;
+			if (count > buffer->capacity)
+			{
+				stats.overwritten += count - buffer->capacity;
+			}
+		}
+
+		return stats;
+	}
+
+	void Trace::exportChromeTrace(const std::string& path, NameResolver resolver, void* userData)
+	{
+		struct Snapshot
+		{
+			uint32_t tid;
+			std::string name;
+			std::vector<Event> events;
+		};
+		std::vector<Snapshot> snapshots;
+
+		{
+			std::lock_guard<std::mutex> lock(registryLock);
+
+			for (auto& buffer : buffers)
+			{
+				const uint64_t capacity = buffer->capacity;
+				const uint64_t startPos = buffer->start;
+				const uint64_t endPos = buffer->head.load(std::memory_order_acquire);
+
+				Snapshot snapshot;
+				snapshot.tid = buffer->tid;
+				snapshot.name = buffer->name;
+
+				uint64_t first = std::max(startPos, endPos > capacity ? endPos - capacity : 0);
+				for (uint64_t pos = first; pos < endPos; ++pos)
+				{
+					snapshot.events.push_back(buffer->events[pos % capacity]);
+				}
+
+				// The slot after head may have been written while copying, along
+				// with anything else the owner got to
+				const uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+				const uint64_t firstIntact = headAfter + 1 > capacity ? headAfter + 1 - capacity : 0;
+				if (firstIntact > first)
+				{
+					size_t lost = (size_t)std::min<uint64_t>(firstIntact - first, snapshot.events.size());
+					snapshot.events.erase(snapshot.events.begin(), snapshot.events.begin() + lost);
+				}
+
+				snapshots.push_back(std::move(snapshot));
+			}
+		}
+
+		std::ofstream out(path);
+		if (!out)
+		{
+			throw std::runtime_error("Failed to open " + path + " for writing");
+		}
+
+		std::map<ResId, std::string> names;
+		auto resName = [&](ResId res) -> const std::string&
+		{
+			auto iter = names.find(res);
+			if (iter == names.end())
+			{
+				std::ostringstream name;
+				if (resolver)
+				{
+					name << escape(resolver(res, userData));
+				}
+				else
+				{
+					name << std::hex << res;
+				}
+				iter = names.insert(std::make_pair(res, name.str())).first;
+			}
+			return iter->second;
+		};
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool first = true;
+		for (const auto& snapshot : snapshots)
+		{
+			if (!snapshot.name.empty())
+			{
+				out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << snapshot.tid
+					<< ",\"args\":{\"name\":\"" << escape(snapshot.name) << "\"}}";
+				first = false;
+			}
+
+			for (const Event& event : snapshot.events)
+			{
+				out << (first ? "" : ",\n");
+				first = false;
+
+				const char* typeName = event.type < NumEventTypes ? eventNames[event.type] : "Unknown";
+
+				switch (event.type)
+				{
+				case LoadBegin:
+				case LoadEnd:
+				case LoadFailed:
+					// Loads may move between threads, so they are async events keyed by resource
+					out << "{\"name\":\"" << resName(event.res) << "\",\"cat\":\"load\",\"ph\":\""
+						<< (event.type == LoadBegin ? 'b' : 'e') << "\",\"id\":" << event.res;
+					if (event.type == LoadFailed)
+					{
+						out << ",\"args\":{\"failed\":true}";
+					}
+					else if (event.type == LoadEnd)
+					{
+						out << ",\"args\":{\"tier\":" << event.value << '}';
+					}
+					break;
+
+				default:
+					out << "{\"name\":\"" << typeName << "\",\"cat\":\"cache\",\"ph\":\"i\",\"s\":\"t\""
+						<< ",\"args\":{\"res\":\"" << resName(event.res) << "\",\"value\":" << event.value << '}';
+					break;
+				}
+
+				out << ",\"ts\":" << event.timeUs << ",\"pid\":1,\"tid\":" << snapshot.tid << '}';
+			}
+		}
+
+		out << "\n]}\n";
+	}
+}
@@ -0,0 +1,84 @@
+#include "TwoQueueEvictionPolicy.h"
+
+namespace GENA
+{
+	TwoQueueEvictionPolicy::TwoQueueEvictionPolicy()
+		: capacity(0)
+	{
+	}
+
+	std::unique_ptr<IEvictionPolicy> TwoQueueEvictionPolicy::create()
+	{
+		return std::unique_ptr<IEvictionPolicy>(new TwoQueueEvictionPolicy());
+	}
+
+	std::string TwoQueueEvictionPolicy::getName() const
+	{
+		return "2Q";
+	}
+
+	void TwoQueueEvictionPolicy::setCapacity(uint64_t bytes)
+	{
+		capacity = bytes;
+	}
+
+	void TwoQueueEvictionPolicy::inserted(ResId res, uint64_t size)
+	{
+		removed(res);
+
+		if (a1out.remove(res))
+		{
+			am.pushFront(res, size);
+		}
+		else
+		{
+			a1in.pushFront(res, size);
+		}
+	}
+
+	void TwoQueueEvictionPolicy::accessed(ResId res)
+	{
+		// Hits in A1in are treated as correlated references and ignored
+		if (am.contains(res))
+		{
+			am.moveToFront(res);
+		}
+	}
+
+	void TwoQueueEvictionPolicy::removed(ResId res)
+	{
+		if (!a1in.remove(res))
+		{
+			am.remove(res);
+		}
+	}
+
+	bool TwoQueueEvictionPolicy::empty() const
+	{
+		return a1in.empty() && am.empty();
+	}
+
+	IEvictionPolicy::ResId TwoQueueEvictionPolicy::selectVictim()
+	{
+		// Kin and Kout as recommended in the paper: 25% and 50% of the cache
+		const uint64_t maxA1in = capacity / 4;
+		const uint64_t maxA1out = capacity / 2;
+
+		uint64_t size;
+
+		if (am.empty() || (!a1in.empty() && a1in.getBytes() > maxA1in))
+		{
+			ResId victim = a1in.popBack(size);
+
+			a1out.pushFront(victim, size);
+			while (a1out.getBytes() > maxA1out && !a1out.empty())
+			{
+				a1out.popBack(size);
+			}
+
+			return victim;
+		}
+
+		return am.popBack(size);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * Compact binary log of the requests a cache served, for replaying a
+	 * real session against simulated caches. A file is a header followed
+	 * by fixed size records in the order they were recorded.
+	 */
+	class AccessTrace
+	{
+	public:
+		typedef uint32_t ResId;
+
+		enum EventType
+		{
+			/** A resource asked for through getHandle. */
+			Request,
+			/** A resource asked for through preload, prefetch or a set. */
+			Preload,
+			/** A resource loaded into the cache, with its charged size. */
+			Load,
+			/** A resource evicted from the cache, with its charged size. */
+			Evict
+		};
+
+		/**
+		 * Sizes of requests are 0 when the resource was not in memory,
+		 * the load that follows has it.
+		 */
+		struct Record
+		{
+			uint64_t timeUs;
+			uint64_t size;
+			ResId res;
+			uint32_t type;
+		};
+
+	private:
+		static const size_t flushRecords = 4096;
+
+		std::ofstream out;
+		std::vector<Record> pending;
+		std::mutex lock;
+		std::atomic<bool> recording;
+		std::chrono::high_resolution_clock::time_point startTime;
+
+	public:
+		AccessTrace();
+		~AccessTrace();
+
+		/**
+		 * Starts a new trace file, closing any open one first.
+		 */
+		void open(const std::string& path);
+		void close();
+
+		bool isRecording() const
+		{
+			return recording;
+		}
+
+		void record(EventType type, ResId res, uint64_t size);
+
+		/**
+		 * Reads a whole trace file. Throws if it is not a trace file.
+		 */
+		static std::vector<Record> read(const std::string& path);
+
+	private:
+		void flush();
+
+		AccessTrace(const AccessTrace&); // delete
+		AccessTrace& operator=(const AccessTrace&); // delete
+	};
+}
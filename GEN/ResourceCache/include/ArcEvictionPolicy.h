@@ -0,0 +1,43 @@
+#pragma once
+
+#include "IEvictionPolicy.h"
+#include "SizedLruList.h"
+
+namespace GENA
+{
+	/**
+	 * Adaptive Replacement Cache (Megiddo & Modha) measured in bytes.
+	 *
+	 * Resources seen once live in T1 and resources seen again in T2. Ghost
+	 * lists B1 and B2 remember what was recently evicted from each, and hits
+	 * in them move the target size of T1 towards whichever list would have
+	 * kept the resource, balancing recency against frequency.
+	 */
+	class ArcEvictionPolicy : public IEvictionPolicy
+	{
+	private:
+		SizedLruList t1;
+		SizedLruList t2;
+		SizedLruList b1;
+		SizedLruList b2;
+
+		uint64_t capacity;
+		uint64_t targetT1;
+
+	public:
+		ArcEvictionPolicy();
+
+		static std::unique_ptr<IEvictionPolicy> create();
+
+		std::string getName() const override;
+		void setCapacity(uint64_t bytes) override;
+		void inserted(ResId res, uint64_t size) override;
+		void accessed(ResId res) override;
+		void removed(ResId res) override;
+		bool empty() const override;
+		ResId selectVictim() override;
+
+	private:
+		void trimGhosts();
+	};
+}
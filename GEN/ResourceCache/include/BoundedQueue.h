@@ -0,0 +1,202 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace GENA
+{
+	/**
+	 * Blocking FIFO queue for handing work between threads. push blocks
+	 * while the queue holds capacity items (a capacity of 0 never blocks).
+	 * After close, push fails and pop drains what is left before failing.
+	 * Urgent items are queued after earlier urgent items but ahead of all
+	 * others.
+	 *
+	 * Keeps track of its peak depth and of how long items sat in it.
+	 */
+	template <typename T>
+	class BoundedQueue
+	{
+	public:
+		typedef std::chrono::high_resolution_clock Clock;
+
+	private:
+		std::deque<std::pair<T, Clock::time_point>> items;
+		size_t capacity;
+		size_t numUrgent;
+		bool closed;
+
+		mutable std::mutex lock;
+		std::condition_variable notEmpty;
+		std::condition_variable notFull;
+
+		size_t maxDepth;
+		uint64_t numPopped;
+		Clock::duration totalWait;
+
+	public:
+		explicit BoundedQueue(size_t capacity = 0);
+
+		void setCapacity(size_t capacity);
+
+		bool push(T&& item, bool urgent = false);
+		bool pop(T& item);
+
+		/**
+		 * Like pop, but fails right away if the queue is empty.
+		 */
+		bool tryPop(T& item);
+
+		void close();
+
+		size_t getDepth() const;
+		size_t getMaxDepth() const;
+		uint64_t getNumPopped() const;
+		Clock::duration getTotalWait() const;
+
+	private:
+		// Called with lock held and the queue not empty
+		void popFront(T& item);
+
+		BoundedQueue(const BoundedQueue&); // delete
+		BoundedQueue& operator=(const BoundedQueue&); // delete
+	};
+
+	template <typename T>
+	BoundedQueue<T>::BoundedQueue(size_t capacity)
+		: capacity(capacity),
+		numUrgent(0),
+		closed(false),
+		maxDepth(0),
+		numPopped(0),
+		totalWait(Clock::duration::zero())
+	{
+	}
+
+	template <typename T>
+	void BoundedQueue<T>::setCapacity(size_t capacity)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		this->capacity = capacity;
+		notFull.notify_all();
+	}
+
+	template <typename T>
+	bool BoundedQueue<T>::push(T&& item, bool urgent)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		while (!closed && capacity != 0 && items.size() >= capacity)
+		{
+			notFull.wait(guard);
+		}
+
+		if (closed)
+		{
+			return false;
+		}
+
+		if (urgent)
+		{
+			items.insert(items.begin() + numUrgent, std::make_pair(std::move(item), Clock::now()));
+			++numUrgent;
+		}
+		else
+		{
+			items.push_back(std::make_pair(std::move(item), Clock::now()));
+		}
+		if (items.size() > maxDepth)
+		{
+			maxDepth = items.size();
+		}
+
+		notEmpty.notify_one();
+		return true;
+	}
+
+	template <typename T>
+	bool BoundedQueue<T>::pop(T& item)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		while (!closed && items.empty())
+		{
+			notEmpty.wait(guard);
+		}
+
+		if (items.empty())
+		{
+			return false;
+		}
+
+		popFront(item);
+		return true;
+	}
+
+	template <typename T>
+	bool BoundedQueue<T>::tryPop(T& item)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (items.empty())
+		{
+			return false;
+		}
+
+		popFront(item);
+		return true;
+	}
+
+	template <typename T>
+	void BoundedQueue<T>::popFront(T& item)
+	{
+		item = std::move(items.front().first);
+		totalWait += Clock::now() - items.front().second;
+		++numPopped;
+		items.pop_front();
+		if (numUrgent > 0)
+		{
+			--numUrgent;
+		}
+
+		notFull.notify_one();
+	}
+
+	template <typename T>
+	void BoundedQueue<T>::close()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		closed = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+	template <typename T>
+	size_t BoundedQueue<T>::getDepth() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return items.size();
+	}
+
+	template <typename T>
+	size_t BoundedQueue<T>::getMaxDepth() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return maxDepth;
+	}
+
+	template <typename T>
+	uint64_t BoundedQueue<T>::getNumPopped() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return numPopped;
+	}
+
+	template <typename T>
+	typename BoundedQueue<T>::Clock::duration BoundedQueue<T>::getTotalWait() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return totalWait;
+	}
+}
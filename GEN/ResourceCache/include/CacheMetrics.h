@@ -0,0 +1,135 @@
+#pragma once
+
+#include <ResourceType.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * Counters and load latency histograms of a resource cache, cheap
+	 * enough to always keep. Every thread counts on a stripe of its own,
+	 * so counting never contends, and the stripes are summed up when a
+	 * snapshot is taken.
+	 */
+	class CacheMetrics
+	{
+	public:
+		enum Counter
+		{
+			/** Requests served from memory, resurrections included. */
+			Hits,
+			/** Hits on resources evicted but still held elsewhere. */
+			Resurrections,
+			Misses,
+			/** Requests that waited for a load someone else started. */
+			CoalescedWaits,
+			Evictions,
+			Loads,
+			/** Bytes read from the resource file. */
+			BytesLoaded,
+			/** Bytes inflated, from the resource file or the compressed tier. */
+			BytesDecompressed,
+			NumCounters
+		};
+
+		/**
+		 * Latency buckets are powers of two in microseconds. Bucket 0 holds
+		 * loads under 1 us, bucket i those under 2^i us and the last bucket
+		 * everything slower.
+		 */
+		static const unsigned int numLatencyBuckets = 24;
+
+		/**
+		 * Resource types tracked separately, types beyond them are lumped
+		 * together under "other".
+		 */
+		static const unsigned int maxTypes = 31;
+
+		/**
+		 * Time from a load being requested until it was in the cache, for
+		 * one resource type.
+		 */
+		struct TypeLatency
+		{
+			std::string type;
+			uint64_t loads;
+			double avgMs;
+			double maxMs;
+			uint64_t buckets[numLatencyBuckets];
+
+			/**
+			 * Upper bound of the bucket holding the given fraction of loads.
+			 */
+			double getPercentileMs(double fraction) const;
+		};
+
+		struct Snapshot
+		{
+			uint64_t counters[NumCounters];
+			double hitRate;
+			std::vector<TypeLatency> latencies;
+		};
+
+	private:
+		static const unsigned int numStripes = 16;
+
+		/**
+		 * Padded to keep stripes counted on by different threads on
+		 * different cache lines.
+		 */
+		struct Stripe
+		{
+			std::atomic<uint64_t> counters[NumCounters];
+			char padding[64];
+		};
+
+		struct TypeSlot
+		{
+			std::atomic<uint64_t> key;
+			std::atomic<uint64_t> loads;
+			std::atomic<uint64_t> totalUs;
+			std::atomic<uint64_t> maxUs;
+			std::atomic<uint64_t> buckets[numLatencyBuckets];
+		};
+
+		Stripe stripes[numStripes];
+		TypeSlot types[maxTypes + 1];
+
+	public:
+		CacheMetrics();
+
+		void add(Counter counter, uint64_t amount = 1);
+
+		/**
+		 * Adds a load of a resource of the given type, as returned by
+		 * IResourceFile::getResourceTypeCode, that took latencyUs.
+		 */
+		void recordLatency(ResourceType type, uint64_t latencyUs);
+
+		Snapshot getSnapshot() const;
+		void reset();
+
+		static const char* getCounterName(Counter counter);
+
+		/**
+		 * Writes the counters of snapshots as CSV rows, one row per snapshot,
+		 * for following them over time.
+		 */
+		static void writeCounterHeader(std::ostream& out);
+		static void writeCounterRow(std::ostream& out, const Snapshot& snapshot);
+
+		/**
+		 * Writes the latencies of a snapshot as CSV, one row per type.
+		 */
+		static void writeLatencyCsv(std::ostream& out, const Snapshot& snapshot);
+
+	private:
+		CacheMetrics(const CacheMetrics&); // delete
+		CacheMetrics& operator=(const CacheMetrics&); // delete
+	};
+}
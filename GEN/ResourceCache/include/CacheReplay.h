@@ -0,0 +1,45 @@
+#pragma once
+
+#include "AccessTrace.h"
+#include "IEvictionPolicy.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * A resource asked for during a recorded or generated session, with
+	 * the size it takes up in the cache.
+	 */
+	struct ReplayAccess
+	{
+		IEvictionPolicy::ResId res;
+		uint64_t size;
+	};
+
+	struct ReplayResult
+	{
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+		uint64_t bytesLoaded;
+		uint64_t bytesReloaded;
+		uint64_t peakBytes;
+	};
+
+	/**
+	 * Turns the requests and preloads of an access trace into accesses.
+	 * Requests for resources that were not in memory carry no size, so
+	 * every access gets the largest size recorded for its resource.
+	 */
+	std::vector<ReplayAccess> extractAccesses(const std::vector<AccessTrace::Record>& records);
+
+	/**
+	 * Replays accesses against a cache of capacity bytes evicting by policy,
+	 * loading on every miss and evicting until the loaded resource fits.
+	 * Resources larger than the whole cache are loaded but never kept. Only
+	 * misses on resources loaded before count as reloaded bytes.
+	 */
+	ReplayResult replayAccesses(const std::vector<ReplayAccess>& accesses, IEvictionPolicy& policy, uint64_t capacity);
+}
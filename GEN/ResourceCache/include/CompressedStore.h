@@ -0,0 +1,90 @@
+#pragma once
+
+#include "SizedLruList.h"
+
+#include <Buffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace GENA
+{
+	/**
+	 * Second level of the resource cache. Keeps resources evicted from
+	 * memory deflated in a budget of its own, so that going back to them
+	 * costs an inflate instead of a trip to the disk. Least recently stored
+	 * resources are dropped first when the budget runs out.
+	 */
+	class CompressedStore
+	{
+	public:
+		typedef uint32_t ResId;
+
+		struct Stats
+		{
+			uint64_t stored;
+			uint64_t rejected;
+			uint64_t evicted;
+			uint64_t numResources;
+			uint64_t compressedBytes;
+			uint64_t rawBytes;
+		};
+
+	private:
+		struct Entry
+		{
+			Buffer data;
+			uint64_t rawSize;
+		};
+
+		std::map<ResId, Entry> entries;
+		SizedLruList order;
+		uint64_t budget;
+		uint64_t rawBytes;
+		mutable std::mutex lock;
+
+		std::atomic<uint64_t> numStored;
+		std::atomic<uint64_t> numRejected;
+		std::atomic<uint64_t> numEvicted;
+
+		void erase(ResId res);
+
+	public:
+		explicit CompressedStore(uint64_t budget);
+
+		/**
+		 * Shrinking the budget drops resources right away.
+		 */
+		void setBudget(uint64_t bytes);
+		uint64_t getBudget() const;
+
+		/**
+		 * Compresses size bytes of data and keeps them as res, replacing any
+		 * earlier copy. Resources that do not compress, or do not fit the
+		 * budget at all, are not kept.
+		 */
+		void store(ResId res, const char* data, uint64_t size);
+
+		/**
+		 * Uncompressed size of res, or 0 if it is not stored.
+		 */
+		uint64_t getRawSize(ResId res) const;
+
+		/**
+		 * Inflates res into buffer, which must hold getRawSize(res) bytes, and
+		 * removes it from the store. Returns false if res is not stored.
+		 */
+		bool take(ResId res, char* buffer, uint64_t size);
+
+		/**
+		 * Drops res, if stored, like when the resource has changed.
+		 */
+		void remove(ResId res);
+
+		void clear();
+
+		Stats getStats() const;
+	};
+}
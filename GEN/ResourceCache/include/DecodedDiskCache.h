@@ -0,0 +1,76 @@
+#pragma once
+
+#include "IResourceFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace GENA
+{
+	/**
+	 * Keeps what loaders have built from resources in a directory on disk,
+	 * one file per resource, so that a later run can map the result instead
+	 * of reading and parsing the resource again. Every file records the
+	 * checksum of the resource and the version of the loader it was built
+	 * with, and is only used while both still match.
+	 */
+	class DecodedDiskCache
+	{
+	public:
+		typedef IResourceFile::ResId ResId;
+
+		struct Stats
+		{
+			uint64_t hits;
+			uint64_t misses;
+			uint64_t stale;
+			uint64_t stores;
+			uint64_t failedStores;
+		};
+
+	private:
+		struct FileHeader
+		{
+			char magic[4];
+			uint32_t checksum;
+			uint32_t version;
+			ResId res;
+			uint64_t size;
+		};
+
+		std::string directory;
+
+		std::atomic<uint64_t> numHits;
+		std::atomic<uint64_t> numMisses;
+		std::atomic<uint64_t> numStale;
+		std::atomic<uint64_t> numStores;
+		std::atomic<uint64_t> numFailedStores;
+
+		std::string getPath(ResId res) const;
+
+	public:
+		DecodedDiskCache();
+
+		/**
+		 * Directory to keep the files in, created if missing. An empty
+		 * path, the default, turns the cache off.
+		 */
+		void setDirectory(const std::string& path);
+		bool isEnabled() const;
+
+		/**
+		 * Maps the saved output for res if it was built from the same
+		 * contents with the same loader version.
+		 */
+		bool find(ResId res, uint32_t checksum, uint32_t version, IResourceFile::MappedView& view);
+
+		/**
+		 * Saves size bytes of loader output for res, replacing anything
+		 * saved before. Failing to write only costs the next run a load.
+		 */
+		void store(ResId res, uint32_t checksum, uint32_t version, const char* data, uint64_t size);
+
+		Stats getStats() const;
+	};
+}
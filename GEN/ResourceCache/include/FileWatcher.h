@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <thread>
+
+namespace GENA
+{
+	/**
+	 * Calls back, from a thread of its own, whenever a file has been
+	 * written to or replaced. The directory is watched rather than the
+	 * file, so files replaced by renaming another over them are noticed
+	 * as well. Changes coming in bursts, like a file being written in
+	 * parts, are reported once the file has been left alone for a while.
+	 */
+	class FileWatcher
+	{
+	public:
+		typedef void (*ChangeCallback)(void* userData);
+
+	private:
+		std::string directory;
+		std::string filename;
+		ChangeCallback callback;
+		void* userData;
+#ifdef _WIN32
+		void* changeHandle;
+		void* stopEvent;
+#else
+		int notifyDesc;
+		int stopPipe[2];
+#endif
+		std::thread watcher;
+
+	public:
+		/**
+		 * Starts watching filepath. Throws if it can't be watched.
+		 */
+		FileWatcher(const std::string& filepath, ChangeCallback callback, void* userData);
+
+		/**
+		 * Stops watching, waiting for a callback under way to return.
+		 */
+		~FileWatcher();
+
+	private:
+		FileWatcher(const FileWatcher&); // delete
+		FileWatcher& operator=(const FileWatcher&); // delete
+
+		void run();
+	};
+}
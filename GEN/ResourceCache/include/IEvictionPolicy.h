@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace GENA
+{
+	/**
+	 * Decides which resident resource a cache shard gives up when it needs room.
+	 *
+	 * The cache reports every resource that becomes resident, every hit on a
+	 * resident resource and every resource it drops for other reasons. When it
+	 * needs memory it asks for a victim, which the policy forgets (but may keep
+	 * in its history) before returning it. Sizes are in bytes.
+	 */
+	class IEvictionPolicy
+	{
+	public:
+		typedef uint32_t ResId;
+
+		virtual std::string getName() const = 0;
+		virtual void setCapacity(uint64_t bytes) = 0;
+		virtual void inserted(ResId res, uint64_t size) = 0;
+		virtual void accessed(ResId res) = 0;
+		virtual void removed(ResId res) = 0;
+		virtual bool empty() const = 0;
+		virtual ResId selectVictim() = 0;
+		virtual ~IEvictionPolicy() {}
+	};
+
+	typedef std::unique_ptr<IEvictionPolicy> (*EvictionPolicyFactory)();
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <ResourceType.h>
+
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace GENA
 {
@@ -10,13 +14,100 @@ namespace GENA
 	public:
 		typedef uint32_t ResId;
 
+		/**
+		 * Read-only bytes of a stored resource, valid for as long as mapping
+		 * is kept alive.
+		 */
+		struct MappedView
+		{
+			const char* data;
+			uint64_t size;
+			std::shared_ptr<const void> mapping;
+		};
+
 		virtual void open() = 0;
 		virtual uint64_t getRawResourceSize(ResId res) = 0;
 		virtual void getRawResource(ResId res, char* buffer) = 0;
 		virtual uint32_t getNumResources() const = 0;
 		virtual ResId getResourceId(uint32_t num) const = 0;
-		virtual std::string getResourceName(ResId res) const = 0;
+		virtual const std::string& getResourceName(ResId res) const = 0;
 		virtual std::string getResourceType(ResId res) const = 0;
+
+		/**
+		 * getResourceType packed for comparing, see ResourceType. Files
+		 * that keep types packed return them without building strings.
+		 */
+		virtual ResourceType getResourceTypeCode(ResId res) const { return packResourceType(getResourceType(res)); }
+
+		/**
+		 * Looks up a resource by name. Files are expected to index their
+		 * names when opened, see ResourceNameIndex, the default scans all
+		 * resources.
+		 *
+		 * @returns false if no resource is called name.
+		 */
+		virtual bool findResource(const std::string& name, ResId& res) const
+		{
+			const uint32_t numRes = getNumResources();
+			for (uint32_t i = 0; i < numRes; ++i)
+			{
+				const ResId id = getResourceId(i);
+				if (getResourceName(id) == name)
+				{
+					res = id;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Resources needed along with res, like the textures of a model, as
+		 * recorded when the file was built.
+		 */
+		virtual std::vector<ResId> getResourceDependencies(ResId /*res*/) const { return std::vector<ResId>(); }
+
+		/**
+		 * Changes whenever the contents of res change. 0 if the file can't
+		 * tell, in which case nothing built from res is kept across runs.
+		 */
+		virtual uint32_t getResourceChecksum(ResId /*res*/) const { return 0; }
+
+		/**
+		 * Points view straight at the stored bytes of res if the file keeps
+		 * them uncompressed in memory mapped storage.
+		 *
+		 * @returns false if res has to be copied out with getRawResource.
+		 */
+		virtual bool mapRawResource(ResId /*res*/, MappedView& /*view*/) { return false; }
+
+		/**
+		 * Reading a resource is split in two so that the I/O and the CPU
+		 * heavy part can run on different threads. getStoredResource only
+		 * reads the bytes as kept in the file and decodeResource turns them
+		 * into the raw resource. Files that store resources as is leave
+		 * needsDecode false and the stored bytes are used directly.
+		 */
+		virtual uint64_t getStoredResourceSize(ResId res) { return getRawResourceSize(res); }
+		virtual void getStoredResource(ResId res, char* buffer) { getRawResource(res, buffer); }
+		virtual bool needsDecode(ResId /*res*/) const { return false; }
+		virtual void decodeResource(ResId /*res*/, const char* /*stored*/, uint64_t /*storedSize*/, char* /*buffer*/) {}
+
+		/**
+		 * Path of the file on disk, for watching it. Empty if the file is
+		 * not on disk.
+		 */
+		virtual std::string getFilePath() const { return std::string(); }
+
+		/**
+		 * Picks up changes made to the file since it was opened, without
+		 * reading more than it takes to tell which resources changed. Reads
+		 * already under way finish with the contents they started with.
+		 *
+		 * @param changed Set to the resources added, removed or changed.
+		 * @returns false if the file can't reload.
+		 */
+		virtual bool reload(std::vector<ResId>& /*changed*/) { return false; }
 		virtual ~IResourceFile() {}
 	};
 }
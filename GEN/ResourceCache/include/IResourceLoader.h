@@ -10,6 +10,21 @@
 
 namespace GENA
 {
+	/**
+	 * Hands out the cache memory a loader decodes a resource into.
+	 */
+	class ILoadTarget
+	{
+	public:
+		/**
+		 * Allocates the loaded resource, size bytes of cache memory.
+		 *
+		 * @returns nullptr if the cache is out of memory.
+		 */
+		virtual std::shared_ptr<ResourceHandle> allocate(uint64_t size) = 0;
+		virtual ~ILoadTarget() {}
+	};
+
 	class IResourceLoader
 	{
 	public:
@@ -17,5 +32,34 @@ namespace GENA
 		virtual bool useRawFile() = 0;
 		virtual uint64_t getLoadedResourceSize(const Buffer& rawBuffer) = 0;
 		virtual bool loadResource(const Buffer& rawBuffer, std::shared_ptr<ResourceHandle> handle) = 0;
+
+		/**
+		 * Version of the format loadResource produces. Loaders whose output
+		 * is plain bytes, without pointers, return a non-zero version to
+		 * allow the output to be saved and reused by later runs. Bump it
+		 * whenever the output changes.
+		 */
+		virtual uint32_t getVersion() { return 0; }
+
+		/**
+		 * Loads rawBuffer in one pass, allocating the loaded resource from
+		 * target as soon as its size is known and decoding straight into it.
+		 * Loaders that can tell the size from a header, or that parse into
+		 * something small along the way, override this to not parse twice.
+		 * The default calls getLoadedResourceSize and then loadResource.
+		 *
+		 * @returns nullptr if loading failed or the cache is out of memory.
+		 */
+		virtual std::shared_ptr<ResourceHandle> load(const Buffer& rawBuffer, ILoadTarget& target)
+		{
+			std::shared_ptr<ResourceHandle> handle = target.allocate(getLoadedResourceSize(rawBuffer));
+			if (!handle || !loadResource(rawBuffer, handle))
+			{
+				return nullptr;
+			}
+			return handle;
+		}
+
+		virtual ~IResourceLoader() {}
 	};
 }
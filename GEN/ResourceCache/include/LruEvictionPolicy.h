@@ -0,0 +1,30 @@
+#pragma once
+
+#include "IEvictionPolicy.h"
+
+#include <list>
+#include <unordered_map>
+
+namespace GENA
+{
+	/**
+	 * Evicts the least recently used resource.
+	 */
+	class LruEvictionPolicy : public IEvictionPolicy
+	{
+	private:
+		std::list<ResId> order;
+		std::unordered_map<ResId, std::list<ResId>::iterator> positions;
+
+	public:
+		static std::unique_ptr<IEvictionPolicy> create();
+
+		std::string getName() const override;
+		void setCapacity(uint64_t bytes) override;
+		void inserted(ResId res, uint64_t size) override;
+		void accessed(ResId res) override;
+		void removed(ResId res) override;
+		bool empty() const override;
+		ResId selectVictim() override;
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace GENA
+{
+	class PositionalFile;
+
+	/**
+	 * A whole file mapped read-only into the address space. The mapping is
+	 * released when the object is destroyed.
+	 */
+	class MappedFile
+	{
+	private:
+#ifdef _WIN32
+		void* fileHandle;
+		void* mappingHandle;
+#else
+		int fileDesc;
+#endif
+		const char* mapData;
+		uint64_t mapSize;
+
+	public:
+		explicit MappedFile(const std::string& filepath);
+
+		/**
+		 * Maps the file open in file, whatever has been renamed over its
+		 * path since. Keeps a handle of its own, file can be closed first.
+		 */
+		explicit MappedFile(const PositionalFile& file);
+
+		~MappedFile();
+
+		const char* data() const;
+		uint64_t size() const;
+
+	private:
+		void mapOpenFile(const std::string& name);
+
+		MappedFile(const MappedFile&); // delete
+		MappedFile& operator=(const MappedFile&); // delete
+	};
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "IResourceFile.h"
+#include "ResourceNameIndex.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * Several resource files mounted as one, like a base archive with patch
+	 * and DLC archives on top. A resource in more than one file is taken
+	 * from the one mounted with the highest priority, so a patch only has
+	 * to hold the resources it changes or adds. Which file serves which
+	 * resource is worked out once when opened and kept in one index, every
+	 * call after that goes straight to the right file.
+	 */
+	class OverlayResourceFile : public IResourceFile
+	{
+	private:
+		// Shared rather than unique, VS2012 does not generate the moves a vector of these would need
+		struct Mount
+		{
+			std::shared_ptr<IResourceFile> file;
+			int priority;
+		};
+
+		/**
+		 * The file serving each resource. Replaced as a whole on reload,
+		 * reads in progress keep the one they started with.
+		 */
+		struct Merged
+		{
+			std::unordered_map<ResId, IResourceFile*> owners;
+			std::vector<ResId> ids;
+		};
+
+		// Highest priority first
+		std::vector<Mount> mounts;
+		std::shared_ptr<const Merged> merged;
+		ResourceNameIndex names;
+		// Held just long enough to copy or swap the above
+		mutable std::mutex reloadLock;
+
+		std::shared_ptr<const Merged> merge() const;
+		std::shared_ptr<const Merged> getMerged() const;
+		IResourceFile& getOwner(ResId res) const;
+
+	public:
+		OverlayResourceFile();
+
+		/**
+		 * Adds file on top of, or below, those mounted so far. Of files
+		 * mounted with the same priority the one mounted last wins. Must be
+		 * done before opening.
+		 */
+		void mount(std::unique_ptr<IResourceFile>&& file, int priority);
+
+		size_t getNumMounts() const;
+
+		/**
+		 * Opens every mounted file. Throws if two different resources share
+		 * a name.
+		 */
+		void open() override;
+		uint64_t getRawResourceSize(ResId res) override;
+		void getRawResource(ResId res, char* buffer) override;
+		uint32_t getNumResources() const override;
+		ResId getResourceId(uint32_t num) const override;
+		const std::string& getResourceName(ResId res) const override;
+		bool findResource(const std::string& name, ResId& res) const override;
+		std::string getResourceType(ResId res) const override;
+		ResourceType getResourceTypeCode(ResId res) const override;
+		std::vector<ResId> getResourceDependencies(ResId res) const override;
+		uint32_t getResourceChecksum(ResId res) const override;
+		bool mapRawResource(ResId res, MappedView& view) override;
+		uint64_t getStoredResourceSize(ResId res) override;
+		void getStoredResource(ResId res, char* buffer) override;
+		bool needsDecode(ResId res) const override;
+		void decodeResource(ResId res, const char* stored, uint64_t storedSize, char* buffer) override;
+
+		/**
+		 * Reloads every mounted file that can. Resources only count as
+		 * changed if what is served for them changed, changes hidden by a
+		 * file of higher priority are left out.
+		 */
+		bool reload(std::vector<ResId>& changed) override;
+
+	private:
+		OverlayResourceFile(const OverlayResourceFile&); // delete
+		OverlayResourceFile& operator=(const OverlayResourceFile&); // delete
+	};
+}
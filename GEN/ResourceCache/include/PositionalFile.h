@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * A file open for reading at given offsets. Reads carry their own
+	 * offset instead of moving a shared position, so any number of threads
+	 * can read at once without locking.
+	 */
+	class PositionalFile
+	{
+	private:
+#ifdef _WIN32
+		void* fileHandle;
+#else
+		int fileDesc;
+#endif
+		uint64_t fileSize;
+
+	public:
+		explicit PositionalFile(const std::string& filepath);
+		~PositionalFile();
+
+		/**
+		 * Reads size bytes at offset into buffer. Throws if the file ends
+		 * before that or the read fails.
+		 */
+		void read(uint64_t offset, char* buffer, uint64_t size) const;
+
+		uint64_t size() const;
+
+	private:
+		// Maps the very file open here, see MappedFile(const PositionalFile&)
+		friend class MappedFile;
+
+		PositionalFile(const PositionalFile&); // delete
+		PositionalFile& operator=(const PositionalFile&); // delete
+	};
+
+	/**
+	 * Reads a PositionalFile front to back as a stream, for formats parsed
+	 * through one. The position is the buffer's own, other threads keep
+	 * reading the file at their offsets meanwhile.
+	 */
+	class PositionalStreamBuf : public std::streambuf
+	{
+	private:
+		const PositionalFile& file;
+		uint64_t nextOffset;
+		std::vector<char> buffer;
+
+	public:
+		explicit PositionalStreamBuf(const PositionalFile& file);
+
+	protected:
+		int_type underflow() override;
+
+	private:
+		PositionalStreamBuf(const PositionalStreamBuf&); // delete
+		PositionalStreamBuf& operator=(const PositionalStreamBuf&); // delete
+	};
+}
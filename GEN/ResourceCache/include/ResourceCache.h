@@ -1,23 +1,32 @@
 #pragma once
 
 #include "ResourceHandle.h"
+#include "AccessTrace.h"
+#include "BoundedQueue.h"
+#include "CacheMetrics.h"
+#include "CompressedStore.h"
+#include "DecodedDiskCache.h"
+#include "FileWatcher.h"
+#include "IEvictionPolicy.h"
 #include "IResourceFile.h"
 #include "IResourceLoader.h"
 
 #include <atomic>
-#include <list>
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace GENA
 {
-	typedef std::list<std::shared_ptr<ResourceHandle>> ResHandleList;
 	typedef std::map<ResourceHandle::ResId, std::shared_ptr<ResourceHandle>> ResHandleMap;
 	typedef std::map<ResourceHandle::ResId, std::weak_ptr<ResourceHandle>> WeakResMap;
-	typedef std::list<std::shared_ptr<IResourceLoader>> ResourceLoaders;
+	typedef std::vector<std::pair<ResourceType, std::shared_ptr<IResourceLoader>>> ResourceLoaders;
 
 	class ResourceCache
 	{
@@ -25,51 +34,775 @@ namespace GENA
 
 	public:
 		typedef ResourceHandle::ResId ResId;
+		typedef void (*CompletionCallback)(std::shared_ptr<ResourceHandle>, void*);
+
+		/**
+		 * Called once when every member of a resource set has been loaded.
+		 * complete is false if any member failed to load.
+		 */
+		typedef void (*SetCallback)(const std::string& name, bool complete, void* userData);
+
+		/**
+		 * How full the cache is. High is entered when usage passes the high
+		 * watermark and only left again below the low watermark. Critical
+		 * means an allocation did not fit even after evicting everything
+		 * that could be evicted.
+		 */
+		enum PressureLevel
+		{
+			PressureNormal,
+			PressureHigh,
+			PressureCritical
+		};
+
+		/**
+		 * Called whenever the pressure level changes, from whichever thread
+		 * caused the change.
+		 */
+		typedef void (*PressureCallback)(PressureLevel level, uint64_t allocated, uint64_t cacheSize, void* userData);
+
+		/**
+		 * What to do with an allocation that does not fit once every
+		 * unpinned, unused resource has been evicted.
+		 */
+		enum OvercommitPolicy
+		{
+			/** Go over budget, the way the cache always has. */
+			EvictUnpinned,
+			/** Fail the load. */
+			RejectOvercommit,
+			/** Wait for memory to be freed, failing after a timeout. */
+			WaitForRoom
+		};
+
+		/**
+		 * Handles freed by collectGarbage. Batch times are how long freeing
+		 * the handles collected in one call took.
+		 */
+		struct FreeStats
+		{
+			uint64_t freed;
+			uint64_t batches;
+			double lastBatchMs;
+			double maxBatchMs;
+			double totalMs;
+		};
+
+		struct PressureStats
+		{
+			PressureLevel level;
+			uint64_t evictionBatches;
+			uint64_t evicted;
+			uint64_t backgroundBatches;
+			uint64_t backgroundEvicted;
+			uint64_t overcommits;
+			uint64_t rejected;
+			uint64_t waits;
+			double totalWaitMs;
+		};
+
+		/**
+		 * Adds the ids of the resources that source refers to, like the
+		 * objects of a room, to members.
+		 */
+		typedef void (*SetExtractor)(const ResourceHandle& source, std::vector<ResId>& members);
+
+		/**
+		 * How often requests for a resource that was already being loaded
+		 * were folded into that load instead of loading it again. Pipeline
+		 * copies are loads asked for by loaders of their own dependencies,
+		 * see getHandle.
+		 */
+		struct LoadStats
+		{
+			uint64_t loads;
+			uint64_t coalescedRequests;
+			uint64_t duplicateBytesSaved;
+			uint64_t pipelineCopies;
+			uint32_t currentWaiters;
+			uint32_t maxWaiters;
+		};
+
+		/**
+		 * The preload pipeline. Resources are read on the I/O stage, decoded
+		 * and handed to their loader on the decode stage and inserted into
+		 * the cache, with callbacks called, on the completion stage.
+		 */
+		enum PipelineStage
+		{
+			IoStage,
+			DecodeStage,
+			CompletionStage,
+			NumPipelineStages
+		};
+
+		/**
+		 * Load on one pipeline stage. Wait is the time jobs spent queued in
+		 * front of the stage and work the time the stage spent on them.
+		 */
+		struct StageStats
+		{
+			uint32_t threads;
+			uint64_t jobs;
+			uint64_t queueDepth;
+			uint64_t maxQueueDepth;
+			double avgWaitMs;
+			double avgWorkMs;
+		};
+
+		/**
+		 * Where a requested resource was found. Requests missing memory go
+		 * to the compressed tier for raw resources or the decoded disk cache
+		 * for loaded ones, if enabled, and then to the resource file.
+		 */
+		enum CacheTier
+		{
+			MemoryTier,
+			CompressedTier,
+			DiskCacheTier,
+			FileTier,
+			NumCacheTiers
+		};
+
+		/**
+		 * Requests served by a tier and those it had to pass on. Latency is
+		 * the time spent getting the resource out of the tier, not counting
+		 * time queued in the pipeline.
+		 */
+		struct TierStats
+		{
+			uint64_t hits;
+			uint64_t misses;
+			double hitRate;
+			double avgLatencyMs;
+			uint64_t bytesUsed;
+			uint64_t budget;
+		};
+
+		/**
+		 * Memory held by loads in progress outside the cache budget, like
+		 * compressed bytes waiting to be inflated or text waiting to be
+		 * parsed. Loads needing more than the limit allows wait for others
+		 * to finish before reading anything.
+		 */
+		struct ScratchStats
+		{
+			uint64_t limit;
+			uint64_t current;
+			uint64_t peak;
+			uint64_t peakTotal;
+			uint64_t admissionWaits;
+			double totalWaitMs;
+		};
+
+		/**
+		 * Reloads of the resource file. Time is from asking for the reload
+		 * until every changed resource had been invalidated. Failed reloads
+		 * left the file as it was.
+		 */
+		struct ReloadStats
+		{
+			uint64_t reloads;
+			uint64_t failedReloads;
+			uint64_t changedResources;
+			double lastReloadMs;
+			double maxReloadMs;
+		};
 
 	protected:
-		ResHandleList leastRecentlyUsed;
-		std::recursive_mutex leastRecentlyUsedLock;
-		ResHandleMap resources;
-		WeakResMap weakResources;
-		std::recursive_mutex resourcesLock;
+		/**
+		 * Deleter of every handle the cache hands out, which frees the
+		 * handle right away or queues it for collectGarbage.
+		 */
+		struct HandleDeleter
+		{
+			ResourceCache* cache;
+
+			explicit HandleDeleter(ResourceCache* cache);
+			void operator()(ResourceHandle* handle) const;
+		};
+
+		/**
+		 * Cache memory for loaders to decode res into.
+		 */
+		class LoadTarget : public ILoadTarget
+		{
+		private:
+			ResourceCache* cache;
+			ResId res;
+
+		public:
+			LoadTarget(ResourceCache* cache, ResId res);
+			std::shared_ptr<ResourceHandle> allocate(uint64_t size) override;
+		};
+
+		/**
+		 * Cache memory charged to one resource, freed and given back to the
+		 * budget on destruction unless handed on as a buffer for a handle
+		 * to own. Keeps loads that fail halfway from leaking budget.
+		 */
+		class CacheAllocation
+		{
+		private:
+			ResourceCache* cache;
+			ResId res;
+			char* data;
+			uint64_t size;
+
+		public:
+			/**
+			 * Allocates size bytes for res, see ResourceCache::allocate. get
+			 * returns nullptr if the cache is out of memory.
+			 */
+			CacheAllocation(ResourceCache* cache, ResId res, uint64_t size);
+			~CacheAllocation();
+
+			char* get() const;
+
+			/**
+			 * The memory as a buffer, still charged until the handle owning
+			 * it is destroyed.
+			 */
+			Buffer release();
+
+		private:
+			CacheAllocation(const CacheAllocation&); // delete
+			CacheAllocation& operator=(const CacheAllocation&); // delete
+		};
+
+		/**
+		 * Scratch memory set aside for one load, given back on release or
+		 * destruction.
+		 */
+		class ScratchReservation
+		{
+		private:
+			ResourceCache* cache;
+			uint64_t bytes;
+
+		public:
+			ScratchReservation();
+			ScratchReservation(ResourceCache* cache, uint64_t bytes);
+			ScratchReservation(ScratchReservation&& other);
+			~ScratchReservation();
+
+			ScratchReservation& operator=(ScratchReservation&& other);
+			void release();
+
+		private:
+			ScratchReservation(const ScratchReservation&); // delete
+			ScratchReservation& operator=(const ScratchReservation&); // delete
+		};
+
+		/**
+		 * Keeps the resource file from being reloaded while a load reads
+		 * from it, released on release or destruction.
+		 */
+		class FileLease
+		{
+		private:
+			ResourceCache* cache;
+
+		public:
+			FileLease();
+			explicit FileLease(ResourceCache* cache);
+			FileLease(FileLease&& other);
+			~FileLease();
+
+			FileLease& operator=(FileLease&& other);
+			void release();
+
+		private:
+			FileLease(const FileLease&); // delete
+			FileLease& operator=(const FileLease&); // delete
+		};
+
+		/**
+		 * Callback waiting for a load. Only callbacks with notifyFailure set
+		 * are called, with an empty handle, if the load fails.
+		 */
+		struct LoadCallback
+		{
+			CompletionCallback callback;
+			void* userData;
+			bool notifyFailure;
+		};
+
+		/**
+		 * A load currently in progress. Anyone asking for the resource while
+		 * it is loading waits on, or queues a callback with, this entry
+		 * instead of starting a load of their own.
+		 */
+		struct InFlightLoad
+		{
+			std::mutex lock;
+			std::condition_variable loaded;
+			bool done;
+			uint32_t sharers;
+			bool lowPriority;
+			std::atomic<bool> claimed;
+			// Pipeline thread working on the load right now, if any
+			std::thread::id worker;
+			std::shared_ptr<ResourceHandle> handle;
+			std::vector<LoadCallback> callbacks;
+
+			InFlightLoad();
+
+			std::shared_ptr<ResourceHandle> wait();
+		};
+
+		/**
+		 * A resource on its way through the pipeline. stored holds the bytes
+		 * read by the I/O stage until the decode stage has built handle.
+		 */
+		struct LoadJob
+		{
+			ResId res;
+			std::shared_ptr<InFlightLoad> entry;
+			std::shared_ptr<IResourceLoader> loader;
+			Buffer stored;
+			// Keeps stored valid when it views a mapped archive
+			std::shared_ptr<const void> storedMapping;
+			ScratchReservation scratch;
+			FileLease fileLease;
+			// Reload the bytes were read before, see insertLoaded
+			uint32_t generation;
+			std::shared_ptr<ResourceHandle> handle;
+			CacheTier source;
+			uint64_t workUs;
+			std::chrono::high_resolution_clock::time_point requestTime;
+
+			LoadJob();
+		};
+
+		typedef BoundedQueue<std::unique_ptr<LoadJob>> JobQueue;
+
+		struct Stage
+		{
+			JobQueue queue;
+			std::vector<std::thread> threads;
+			unsigned int numThreads;
+			std::atomic<uint64_t> workTimeUs;
+
+			Stage();
+		};
+
+		/**
+		 * A slice of the cache owning every resource whose id hashes to it.
+		 * Each shard has its own eviction policy, maps, lock and share of the
+		 * cache size, so threads working on different shards never contend.
+		 */
+		struct Shard
+		{
+			std::unique_ptr<IEvictionPolicy> policy;
+			ResHandleMap resources;
+			WeakResMap weakResources;
+			std::map<ResId, uint32_t> pins;
+			std::recursive_mutex lock;
+
+			std::atomic<uint64_t> budget;
+			std::atomic<uint64_t> allocated;
+			// Part of allocated held by dead handles waiting for collectGarbage
+			std::atomic<uint64_t> pendingFree;
+			std::atomic<uint64_t> demand;
+
+			Shard();
+
+			/**
+			 * Allocated bytes not already on their way to being freed.
+			 */
+			uint64_t liveBytes() const;
+		};
+
+		std::vector<std::unique_ptr<Shard>> shards;
+		std::mutex rebalanceLock;
+		std::atomic<uint32_t> allocsSinceRebalance;
+		// Few enough that comparing packed types beats hashing them
 		ResourceLoaders resourceLoaders;
+		// The first loader registered, for types nothing else loads
+		std::shared_ptr<IResourceLoader> fallbackLoader;
 
 		std::unique_ptr<IResourceFile> file;
 
+		// Reloads wait for every lease to be returned and new leases for the reload
+		std::mutex fileLeaseLock;
+		std::condition_variable fileLeasesChanged;
+		uint32_t fileLeases;
+		bool fileReloading;
+		// Set once the leases are all back and the file is being swapped
+		bool fileSwapping;
+		std::atomic<uint32_t> fileGeneration;
+		std::mutex reloadLock;
+		std::unique_ptr<FileWatcher> watcher;
+		std::atomic<uint64_t> numReloads;
+		std::atomic<uint64_t> failedReloads;
+		std::atomic<uint64_t> reloadedResources;
+		std::atomic<uint64_t> lastReloadUs;
+		std::atomic<uint64_t> maxReloadUs;
+
 		uint64_t cacheSize;
-		uint64_t allocated;
-		uint64_t maxAllocated;
+		std::atomic<uint64_t> allocated;
+		std::atomic<uint64_t> maxAllocated;
+
+		OvercommitPolicy overcommitPolicy;
+		std::chrono::milliseconds overcommitTimeout;
+		float highWatermark;
+		float lowWatermark;
+		PressureCallback pressureCallback;
+		void* pressureUserData;
+		std::atomic<int> pressureLevel;
+		std::mutex roomLock;
+		std::condition_variable roomFreed;
+		// Counts frees, only changed under roomLock, so a waiter can tell it missed one
+		std::atomic<uint64_t> roomFrees;
+		std::atomic<uint64_t> evictionBatches;
+		std::atomic<uint64_t> numEvicted;
+		std::atomic<uint64_t> numOvercommits;
+		std::atomic<uint64_t> numRejected;
+		std::atomic<uint64_t> numRoomWaits;
+		std::atomic<uint64_t> roomWaitUs;
+
+		bool backgroundEviction;
+		std::thread housekeeper;
+		std::mutex housekeepingLock;
+		std::condition_variable housekeepingWake;
+		bool stopHousekeeping;
+		std::atomic<uint64_t> backgroundBatches;
+		std::atomic<uint64_t> backgroundEvicted;
+
+		std::atomic<bool> deferredFree;
+		std::atomic<ResourceHandle*> deadHandles;
+		std::mutex collectLock;
+		std::atomic<uint64_t> numFreed;
+		std::atomic<uint64_t> freeBatches;
+		std::atomic<uint64_t> lastFreeBatchUs;
+		std::atomic<uint64_t> maxFreeBatchUs;
+		std::atomic<uint64_t> totalFreeUs;
+
+		CacheMetrics metrics;
+		AccessTrace accessTrace;
+
+		std::map<ResId, std::shared_ptr<InFlightLoad>> inFlight;
+		std::mutex inFlightLock;
+		std::atomic<uint64_t> numLoads;
+		std::atomic<uint64_t> coalescedRequests;
+		std::atomic<uint64_t> duplicateBytesSaved;
+		std::atomic<uint64_t> pipelineCopies;
+		std::atomic<uint32_t> currentWaiters;
+		std::atomic<uint32_t> maxWaiters;
+
+		Stage stages[NumPipelineStages];
+		size_t pipelineDepth;
 
-		std::map<ResId, std::thread> workers;
-		std::recursive_mutex workerLock;
-		std::vector<std::thread> doneWorkers;
-		std::mutex doneWorkersLock;
+		struct TierCounters
+		{
+			std::atomic<uint64_t> hits;
+			std::atomic<uint64_t> misses;
+			std::atomic<uint64_t> timeUs;
 
+			TierCounters();
+		};
+
+		uint64_t scratchLimit;
+		uint64_t scratchBytes;
+		std::mutex scratchLock;
+		std::condition_variable scratchFreed;
+		std::atomic<uint64_t> scratchPeak;
+		std::atomic<uint64_t> scratchPeakTotal;
+		std::atomic<uint64_t> admissionWaits;
+		std::atomic<uint64_t> admissionWaitUs;
+
+		CompressedStore compressed;
+		DecodedDiskCache diskCache;
+		std::atomic<bool> compressEvicted;
+		TierCounters tiers[NumCacheTiers];
+
+		/**
+		 * A named group of resources. Every load of the set pins all members
+		 * until the matching release.
+		 */
+		struct ResourceSet
+		{
+			std::vector<ResId> members;
+			uint32_t loadCount;
+		};
+
+		/**
+		 * Progress of one loadSet call, freed when the last member is done.
+		 */
+		struct SetLoad
+		{
+			std::string name;
+			std::atomic<uint32_t> remaining;
+			std::atomic<bool> failed;
+			SetCallback callback;
+			void* userData;
+		};
+
+		std::map<std::string, ResourceSet> sets;
+		std::mutex setLock;
+
+		Shard& getShard(ResId res);
 		std::shared_ptr<ResourceHandle> find(ResId res);
 		void update(std::shared_ptr<ResourceHandle> handle);
 		std::shared_ptr<ResourceHandle> load(ResId res);
-		void asyncLoad(ResId res, void (*completionCallback)(std::shared_ptr<ResourceHandle>, void*), void* userData);
+		std::shared_ptr<IResourceLoader> findLoader(ResId res) const;
+		void readStored(LoadJob& job, bool mayWait);
+		ScratchReservation reserveScratch(uint64_t bytes, bool mayWait);
+		void releaseScratch(uint64_t bytes);
+		FileLease acquireFileLease(bool mayWait);
+		void releaseFileLease();
+		void decode(LoadJob& job);
+		std::shared_ptr<ResourceHandle> insertLoaded(ResId res, std::shared_ptr<ResourceHandle> handle, uint32_t generation);
+		void invalidate(ResId res);
+		static void fileChanged(void* userData);
+		std::shared_ptr<ResourceHandle> loadInFlight(ResId res, std::shared_ptr<InFlightLoad> entry);
+		void completeInFlight(ResId res, std::shared_ptr<InFlightLoad> entry, std::shared_ptr<ResourceHandle> handle);
+		std::shared_ptr<ResourceHandle> waitInFlight(std::shared_ptr<InFlightLoad> entry);
+		bool attachLoad(ResId res, CompletionCallback completionCallback, void* userData, bool notifyFailure, bool lowPriority);
+		void prefetchDependencies(ResId root, bool lowPriority);
+		void startPipeline();
+		void stopPipeline();
+		void runStage(PipelineStage stage);
+		void runJob(PipelineStage stage, std::unique_ptr<LoadJob> job);
+		static void setWorker(InFlightLoad& entry, std::thread::id worker);
+		// NumPipelineStages for threads outside the pipeline
+		PipelineStage findPipelineStage() const;
+		bool isPipelineThread() const;
+		std::shared_ptr<ResourceHandle> helpInFlight(PipelineStage stage, std::shared_ptr<InFlightLoad> entry);
 		void free(std::shared_ptr<ResourceHandle> gonner);
+		void recordAccess(AccessTrace::EventType type, ResId res, uint64_t size);
+		std::shared_ptr<ResourceHandle> adopt(ResourceHandle* handle);
+		void destroyHandle(ResourceHandle* handle);
+		void recordLoad(const LoadJob& job);
+		void handleDestroyed(const ResourceHandle& handle);
 
-		void makeRoom(uint64_t size);
-		char* allocate(uint64_t size);
-		void freeOneResource();
+		bool makeRoom(Shard& shard, uint64_t size);
+		void updatePressure(bool critical);
+		void runHousekeeping();
+		bool trimShard(Shard& shard);
+		char* allocate(uint64_t size, ResId res);
+		void freeOneResource(Shard& shard);
 		void memoryHasBeenFreed(uint64_t size, ResId resId);
+		void rebalanceBudgets(Shard* needy, uint64_t need);
+
+		void pin(ResId res);
+		void unpin(ResId res);
+		static void setMemberLoaded(std::shared_ptr<ResourceHandle> handle, void* userData);
+		static void finishSetMember(SetLoad* setLoad, bool loaded);
 
 	public:
-		ResourceCache(uint64_t sizeInMiB, std::unique_ptr<IResourceFile>&& resFile);
+		/**
+		 * Creates a cache of sizeInMiB mebibytes, split into numShards
+		 * independently locked shards. Budget is moved between shards
+		 * periodically to follow where the allocations are made.
+		 */
+		ResourceCache(uint64_t sizeInMiB, std::unique_ptr<IResourceFile>&& resFile, unsigned int numShards = 1);
 		~ResourceCache();
 
+		/**
+		 * Replaces the eviction policy (LRU by default) of every shard with
+		 * one made by factory. Must be called before any resource is loaded.
+		 */
+		void setEvictionPolicy(EvictionPolicyFactory factory);
+
+		/**
+		 * Pipeline setup, only effective before init. By default there are
+		 * two I/O threads, one decode thread per remaining core and room for
+		 * 16 jobs between two stages.
+		 */
+		void setIoThreads(unsigned int numThreads);
+		void setDecodeThreads(unsigned int numThreads);
+		void setPipelineDepth(size_t depth);
+
+		/**
+		 * Sets aside sizeInMiB mebibytes, on top of the cache size, to keep
+		 * evicted raw resources in compressed form. 0, the default, turns
+		 * the compressed tier off.
+		 */
+		void setCompressedTierSize(uint64_t sizeInMiB);
+
+		/**
+		 * Saves the output of loaders that support it, see
+		 * IResourceLoader::getVersion, in directory and reuses it in later
+		 * runs as long as the resource and loader are unchanged. Set before
+		 * init, off by default.
+		 */
+		void setDecodedCacheDir(const std::string& directory);
+
+		/**
+		 * Most scratch memory loads in progress may hold at once, a quarter
+		 * of the cache size by default. A single load larger than the limit
+		 * is let through once nothing else holds scratch memory.
+		 */
+		void setScratchLimit(uint64_t sizeInMiB);
+
+		/**
+		 * See OvercommitPolicy, EvictUnpinned by default. timeoutMs is how
+		 * long WaitForRoom waits before giving up.
+		 */
+		void setOvercommitPolicy(OvercommitPolicy policy, unsigned int timeoutMs = 1000);
+
+		/**
+		 * Fractions of the cache size. Once eviction is needed it frees
+		 * memory down to low instead of just enough for the allocation at
+		 * hand. Pressure turns high above high and normal again below low.
+		 * 0.95 and 0.9 by default.
+		 */
+		void setWatermarks(float high, float low);
+		void setPressureCallback(PressureCallback callback, void* userData);
+
+		/**
+		 * Starts a thread on init that evicts down to the low watermark
+		 * whenever usage passes the high watermark, so that loads seldom
+		 * have to evict, or free, anything themselves. Off by default.
+		 */
+		void setBackgroundEviction(bool enabled);
+
+		/**
+		 * Instead of freeing a handle on the thread that drops the last
+		 * reference to it, queue it to be freed by collectGarbage, or the
+		 * background eviction thread if running. Queued handles count as
+		 * freed when making room, so memory in use can exceed the cache
+		 * size by what is queued until collected. Off by default.
+		 */
+		void setDeferredFree(bool enabled);
+
+		/**
+		 * Frees every handle queued so far, like at the end of a frame.
+		 * Returns the number of handles freed.
+		 */
+		size_t collectGarbage();
+
+		/**
+		 * Opens the resource file and starts the preload pipeline.
+		 */
 		void init();
+
+		/**
+		 * Makes loader load the resources of the type returned by its
+		 * getPattern, replacing any loader registered for the type before.
+		 */
 		void registerLoader(std::shared_ptr<IResourceLoader> loader);
 
+		/**
+		 * Returns the cached handle of res, loading it if needed. Requests
+		 * for a resource already loading wait for that load. A pipeline
+		 * thread, like one running a completion callback, keeps working on
+		 * its stage while it waits, so a load queued behind it still gets
+		 * done. Only a loader asking for the very resource its thread is
+		 * loading further down the stack reads a copy of its own, and the
+		 * copy is dropped if the other load is cached first.
+		 */
 		std::shared_ptr<ResourceHandle> getHandle(ResId res);
-		void preload(ResId res, void (*completionCallback)(std::shared_ptr<ResourceHandle>, void*), void* userData);
+		/**
+		 * Loads res in the background and calls completionCallback once it
+		 * is in the cache. Everything res depends on, directly or not, is
+		 * fetched at the same time.
+		 */
+		void preload(ResId res, CompletionCallback completionCallback, void* userData);
+
+		/**
+		 * Like preload without a callback, but queued behind every other
+		 * load. Asking for the resource normally while it still waits
+		 * moves it to the front.
+		 */
+		void prefetch(ResId res);
+
+		/**
+		 * res followed by everything it depends on, directly or not.
+		 */
+		std::vector<ResId> getDependencyClosure(ResId res) const;
+		uint64_t getResourceSize(ResId res) const;
 		void flush();
 
-		ResId findByPath(const std::string path) const;
+		/**
+		 * Declares a resource set, replacing any earlier set with the same
+		 * name. Throws if that set is currently loaded.
+		 */
+		void defineSet(const std::string& name, const std::vector<ResId>& members);
+
+		/**
+		 * Declares a set made of source and the resources extractor finds
+		 * in it. source is loaded right away to be examined.
+		 */
+		void defineSetFrom(const std::string& name, ResId source, SetExtractor extractor);
+
+		/**
+		 * Pins every member of the set against eviction and loads the ones
+		 * missing. callback, if any, is called once all of them are loaded.
+		 * Members shared with other loaded sets are pinned once per set and
+		 * never loaded twice. Low priority loads wait behind all others, as
+		 * with prefetch.
+		 */
+		void loadSet(const std::string& name, SetCallback callback, void* userData, bool lowPriority = false);
+
+		/**
+		 * Undoes one loadSet. Members no longer pinned by any set become
+		 * evictable again.
+		 */
+		void releaseSet(const std::string& name);
+
+		/**
+		 * Name lookups go through the index the file built when opened,
+		 * see IResourceFile::findResource.
+		 */
+		ResId findByPath(const std::string& path) const;
+
+		/**
+		 * Returns a copy, the name owned by the file only lasts until a
+		 * reload removes or renames the resource. Throws if res is not in
+		 * the file.
+		 */
 		std::string findPath(ResId res) const;
 
+		/**
+		 * Reloads the index of the resource file, see IResourceFile::reload,
+		 * and drops every resource that changed from the cache. Handles still
+		 * held keep the old bytes and turn stale. Loads reading from the file
+		 * are finished first and new ones wait for the reload. Returns the
+		 * number of resources that changed.
+		 */
+		size_t reloadFile();
+
+		/**
+		 * Watches the resource file and reloads it whenever it is written
+		 * to or replaced. Throws if the file has no path to watch. Off by
+		 * default.
+		 */
+		void setHotReload(bool enabled);
+
+		/**
+		 * Exports the events traced so far as Chrome trace JSON, with
+		 * resources named by their paths. See Trace.
+		 */
+		void exportTrace(const std::string& path) const;
+
+		/**
+		 * Counters and per type load latencies since the cache was created
+		 * or the metrics were last reset. Cheap enough to take every frame.
+		 */
+		CacheMetrics::Snapshot getMetrics() const;
+		void resetMetrics();
+
+		/**
+		 * Records every request, preload, load and eviction to a binary
+		 * access trace at path, until stopped or the cache is destroyed.
+		 * CacheSimulator replays such traces against other cache sizes and
+		 * eviction policies.
+		 */
+		void startAccessTrace(const std::string& path);
+		void stopAccessTrace();
+
 		uint64_t getMaxMemAllocated() const;
+		LoadStats getLoadStats() const;
+		StageStats getStageStats(PipelineStage stage) const;
+		TierStats getTierStats(CacheTier tier) const;
+		CompressedStore::Stats getCompressedStats() const;
+		DecodedDiskCache::Stats getDecodedCacheStats() const;
+		ScratchStats getScratchStats();
+		PressureStats getPressureStats() const;
+		FreeStats getFreeStats() const;
+		ReloadStats getReloadStats() const;
 	};
 }
@@ -2,11 +2,14 @@
 
 #include <Buffer.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
 namespace GENA
 {
+	class ResourceCache;
+
 	class ResourceHandle
 	{
 		friend class ResourceCache;
@@ -18,12 +21,38 @@ namespace GENA
 		ResId resource;
 		Buffer buffer;
 		ResourceCache* resCache;
+		std::shared_ptr<const void> mapping;
+		std::atomic<bool> stale;
+
+		/** Next handle waiting to be freed, when freeing is deferred */
+		ResourceHandle* nextDead;
 
 	public:
 		ResourceHandle(ResId resId, Buffer&& buffer, ResourceCache* resCache);
+
+		/**
+		 * Creates a handle whose buffer is a view into mapped storage, kept
+		 * alive by mapping until the handle is destroyed.
+		 */
+		ResourceHandle(ResId resId, Buffer&& buffer, ResourceCache* resCache, std::shared_ptr<const void> mapping);
 		virtual ~ResourceHandle();
 
+		ResId getId() const;
+
 		Buffer& getBuffer();
 		const Buffer& getBuffer() const;
+
+		/**
+		 * Number of bytes the handle takes from the cache budget, which is
+		 * nothing for views into mapped storage.
+		 */
+		uint64_t getChargedSize() const;
+
+		/**
+		 * True once the resource file has been reloaded with a different
+		 * version of the resource. The buffer keeps the old bytes, asking
+		 * the cache for the resource again gives the new ones.
+		 */
+		bool isStale() const;
 	};
 }
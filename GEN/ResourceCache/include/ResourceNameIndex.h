@@ -0,0 +1,88 @@
+#pragma once
+
+#include "IResourceFile.h"
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace GENA
+{
+	/**
+	 * Name to id lookup of the resources in a file, built once when the
+	 * file is opened. Both directions are hashed, and names are handed out
+	 * by reference, so lookups neither scan nor allocate. A name handed out
+	 * stays valid until its resource is removed or the index rebuilt. Not
+	 * synchronized, files that change the index while in use lock around it.
+	 */
+	class ResourceNameIndex
+	{
+	public:
+		typedef IResourceFile::ResId ResId;
+
+	private:
+		std::unordered_map<std::string, ResId> ids;
+		// Points into the keys of ids, which stay put until erased
+		std::unordered_map<ResId, const std::string*> names;
+
+	public:
+		ResourceNameIndex() {}
+
+		/**
+		 * Indexes every resource of file, replacing anything indexed before.
+		 * Throws if two resources share a name.
+		 *
+		 * @param getName Name of a resource as stored in the file.
+		 */
+		template <typename NameGetter>
+		void build(const IResourceFile& file, NameGetter getName);
+
+		/**
+		 * Adds res, or renames it if already indexed. Throws if another
+		 * resource is called name.
+		 */
+		void set(ResId res, const std::string& name);
+
+		void remove(ResId res);
+
+		/**
+		 * @returns false if no resource is called name.
+		 */
+		bool find(const std::string& name, ResId& res) const;
+
+		/**
+		 * Throws if res is not in the index.
+		 */
+		const std::string& getName(ResId res) const;
+
+		size_t size() const;
+
+	private:
+		ResourceNameIndex(const ResourceNameIndex&); // delete
+		ResourceNameIndex& operator=(const ResourceNameIndex&); // delete
+	};
+
+	template <typename NameGetter>
+	void ResourceNameIndex::build(const IResourceFile& file, NameGetter getName)
+	{
+		const uint32_t numRes = file.getNumResources();
+
+		std::unordered_map<std::string, ResId> newIds(numRes);
+		std::unordered_map<ResId, const std::string*> newNames(numRes);
+
+		for (uint32_t i = 0; i < numRes; ++i)
+		{
+			const ResId res = file.getResourceId(i);
+			auto inserted = newIds.insert(std::make_pair(getName(res), res));
+			if (!inserted.second)
+			{
+				throw std::runtime_error("Resource name " + inserted.first->first + " is used more than once");
+			}
+			newNames[res] = &inserted.first->first;
+		}
+
+		// Moving keeps the nodes, and with them the addresses of the keys
+		ids = std::move(newIds);
+		names = std::move(newNames);
+	}
+}
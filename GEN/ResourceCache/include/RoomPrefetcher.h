@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ResourceCache.h"
+
+#include <cstdint>
+#include <map>
+
+namespace GENA
+{
+	/**
+	 * Loads the rooms ahead of a moving player before they are reached.
+	 *
+	 * Rooms lie one after the other along an axis, roomSize apart. Every
+	 * update looks ahead in the direction of motion and prefetches the
+	 * rooms that will be reached within the horizon, at the current speed.
+	 * Prefetched resources are not pinned, they are evicted like any other
+	 * if the guess was wrong or memory runs short.
+	 */
+	class RoomPrefetcher
+	{
+	public:
+		typedef ResourceCache::ResId ResId;
+
+		/**
+		 * Returns the resource describing room number roomNr.
+		 */
+		typedef ResId (*RoomResolver)(int roomNr, void* userData);
+
+		struct Stats
+		{
+			uint64_t roomsPrefetched;
+			uint64_t roomsReleased;
+			uint64_t bytesRequested;
+			unsigned int roomsHeld;
+		};
+
+	private:
+		ResourceCache& cache;
+		float roomSize;
+		RoomResolver resolver;
+		void* resolverData;
+
+		unsigned int lookahead;
+		float horizon;
+		uint64_t memoryBudget;
+
+		/** Room number to whether it is still ahead */
+		std::map<int, bool> held;
+		std::map<int, std::vector<ResId>> closures;
+		std::map<int, uint64_t> roomSizes;
+		Stats stats;
+
+		uint64_t measureRoom(int roomNr);
+		void holdRoom(int roomNr);
+		void releaseRoom(std::map<int, bool>::iterator room);
+
+	public:
+		RoomPrefetcher(ResourceCache& cache, float roomSize, RoomResolver resolver, void* userData);
+		~RoomPrefetcher();
+
+		/**
+		 * Most rooms to look ahead, not counting the current one. Default 2.
+		 */
+		void setLookahead(unsigned int rooms);
+
+		/**
+		 * Rooms further away than the player travels in this many seconds
+		 * are not prefetched. Default 5.
+		 */
+		void setHorizon(float seconds);
+
+		/**
+		 * Most bytes of raw resources to prefetch for rooms ahead, 0 for no
+		 * limit. Default half the cache size, which leaves the other half
+		 * for the rooms actually in use.
+		 */
+		void setMemoryBudget(uint64_t bytes);
+
+		/**
+		 * Call every frame with the position along the room axis and the
+		 * velocity in units per second.
+		 */
+		void update(float position, float velocity);
+
+		/**
+		 * Forgets every room prefetched, so they are prefetched again once
+		 * ahead. Whatever was loaded stays until evicted.
+		 */
+		void clear();
+
+		Stats getStats() const;
+	};
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace GENA
+{
+	/**
+	 * A recency ordered list of resource ids that keeps track of the total
+	 * size of its members. Building block for the eviction policies.
+	 */
+	class SizedLruList
+	{
+	public:
+		typedef uint32_t ResId;
+
+	private:
+		struct Item
+		{
+			ResId res;
+			uint64_t size;
+		};
+
+		std::list<Item> items;
+		std::unordered_map<ResId, std::list<Item>::iterator> positions;
+		uint64_t bytes;
+
+	public:
+		SizedLruList()
+			: bytes(0)
+		{
+		}
+
+		bool contains(ResId res) const
+		{
+			return positions.count(res) != 0;
+		}
+
+		bool empty() const
+		{
+			return items.empty();
+		}
+
+		uint64_t getBytes() const
+		{
+			return bytes;
+		}
+
+		uint64_t sizeOf(ResId res) const
+		{
+			return positions.at(res)->size;
+		}
+
+		ResId front() const
+		{
+			return items.front().res;
+		}
+
+		ResId back() const
+		{
+			return items.back().res;
+		}
+
+		void pushFront(ResId res, uint64_t size)
+		{
+			Item item = { res, size };
+			items.push_front(item);
+			positions[res] = items.begin();
+			bytes += size;
+		}
+
+		void moveToFront(ResId res)
+		{
+			items.splice(items.begin(), items, positions.at(res));
+		}
+
+		bool remove(ResId res)
+		{
+			auto iter = positions.find(res);
+			if (iter == positions.end())
+			{
+				return false;
+			}
+
+			bytes -= iter->second->size;
+			items.erase(iter->second);
+			positions.erase(iter);
+
+			return true;
+		}
+
+		ResId popBack(uint64_t& size)
+		{
+			Item item = items.back();
+			items.pop_back();
+			positions.erase(item.res);
+			bytes -= item.size;
+
+			size = item.size;
+			return item.res;
+		}
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "IEvictionPolicy.h"
+#include "SizedLruList.h"
+
+#include <vector>
+
+namespace GENA
+{
+	/**
+	 * W-TinyLFU (Einziger, Friedman & Manes) measured in bytes.
+	 *
+	 * New resources enter a small LRU window. When the window overflows its
+	 * oldest resource becomes a candidate for the main segmented LRU, and is
+	 * only admitted if an approximate access frequency, kept in a count-min
+	 * sketch, says it is used more often than the main region's victim.
+	 * One-shot loads therefore never push out the resources every room uses.
+	 */
+	class TinyLfuEvictionPolicy : public IEvictionPolicy
+	{
+	private:
+		/**
+		 * Count-min sketch of 4 bit counters that halves itself periodically
+		 * so old popularity fades.
+		 */
+		class FrequencySketch
+		{
+		private:
+			static const unsigned int numRows = 4;
+			static const uint32_t rowSize = 1 << 14;
+
+			std::vector<uint8_t> counters;
+			uint32_t additions;
+
+			uint32_t index(ResId res, unsigned int row) const;
+
+		public:
+			FrequencySketch();
+
+			void increment(ResId res);
+			unsigned int frequency(ResId res) const;
+		};
+
+		FrequencySketch sketch;
+
+		SizedLruList window;
+		SizedLruList probation;
+		SizedLruList protectedSegment;
+		std::vector<ResId> candidates;
+
+		uint64_t capacity;
+
+	public:
+		TinyLfuEvictionPolicy();
+
+		static std::unique_ptr<IEvictionPolicy> create();
+
+		std::string getName() const override;
+		void setCapacity(uint64_t bytes) override;
+		void inserted(ResId res, uint64_t size) override;
+		void accessed(ResId res) override;
+		void removed(ResId res) override;
+		bool empty() const override;
+		ResId selectVictim() override;
+	};
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Records a trace event if its level is enabled. Cheap enough to leave in
+ * hot paths, a disabled event costs one relaxed load.
+ */
+#define GENA_TRACE(level, type, res, value) \
+	do \
+	{ \
+		if (GENA::Trace::isEnabled(level)) \
+		{ \
+			GENA::Trace::record((type), (res), (value)); \
+		} \
+	} while (false)
+
+namespace GENA
+{
+	/**
+	 * Binary event tracing. Every thread records into a ring buffer of its
+	 * own, without locks, keeping the latest events when it wraps around.
+	 * The buffers can be exported as Chrome trace JSON, viewable in
+	 * chrome://tracing.
+	 */
+	class Trace
+	{
+	public:
+		typedef uint32_t ResId;
+
+		enum Level
+		{
+			Verbose,
+			Info,
+			Warning,
+			Error,
+			Off
+		};
+
+		enum EventType
+		{
+			LoadBegin,
+			LoadEnd,
+			LoadFailed,
+			Hit,
+			Miss,
+			Evict,
+			HandleCreated,
+			HandleMapped,
+			HandleReleased,
+			GraphicsUpload,
+			GraphicsRemove,
+			ReloadFailed,
+			NumEventTypes
+		};
+
+		struct Event
+		{
+			uint64_t timeUs;
+			uint64_t value;
+			ResId res;
+			uint32_t type;
+		};
+
+		struct Stats
+		{
+			uint64_t recorded;
+			uint64_t overwritten;
+			size_t threads;
+		};
+
+		/**
+		 * Looks up the name to show for a resource when exporting.
+		 */
+		typedef std::string (*NameResolver)(ResId res, void* userData);
+
+	private:
+		static std::atomic<int> level;
+
+	public:
+		static bool isEnabled(Level eventLevel)
+		{
+			return eventLevel >= level.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Lowest level recorded, Off by default.
+		 */
+		static void setLevel(Level newLevel);
+		static Level getLevel();
+
+		/**
+		 * Number of events each thread keeps. Only affects threads that
+		 * have not recorded anything yet.
+		 */
+		static void setBufferSize(size_t events);
+
+		/**
+		 * Name of the calling thread in exported traces.
+		 */
+		static void setThreadName(const std::string& name);
+
+		static void record(EventType type, ResId res, uint64_t value);
+
+		/**
+		 * Forgets everything recorded so far.
+		 */
+		static void clear();
+
+		static Stats getStats();
+
+		/**
+		 * Writes everything recorded as Chrome trace JSON. Threads may keep
+		 * recording meanwhile, events they overwrite during the export are
+		 * left out.
+		 */
+		static void exportChromeTrace(const std::string& path, NameResolver resolver = nullptr, void* userData = nullptr);
+	};
+}
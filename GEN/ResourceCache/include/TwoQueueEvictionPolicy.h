@@ -0,0 +1,39 @@
+#pragma once
+
+#include "IEvictionPolicy.h"
+
+#include "SizedLruList.h"
+
+namespace GENA
+{
+	/**
+	 * The full 2Q algorithm (Johnson & Shasha) measured in bytes.
+	 *
+	 * New resources enter a FIFO (A1in) and are evicted from it first, so a
+	 * burst of one-shot loads only flushes the FIFO. Ids evicted from A1in are
+	 * remembered in a ghost FIFO (A1out); being loaded again while remembered
+	 * promotes a resource to the main LRU (Am), which holds the reused ones.
+	 */
+	class TwoQueueEvictionPolicy : public IEvictionPolicy
+	{
+	private:
+		SizedLruList a1in;
+		SizedLruList a1out;
+		SizedLruList am;
+
+		uint64_t capacity;
+
+	public:
+		TwoQueueEvictionPolicy();
+
+		static std::unique_ptr<IEvictionPolicy> create();
+
+		std::string getName() const override;
+		void setCapacity(uint64_t bytes) override;
+		void inserted(ResId res, uint64_t size) override;
+		void accessed(ResId res) override;
+		void removed(ResId res) override;
+		bool empty() const override;
+		ResId selectVictim() override;
+	};
+}
@@ -1,13 +1,16 @@
 #include "Index.h"
 
-#include <chrono>
+#include <PathHash.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 namespace GENA
 {
 	Index::Index()
-		: hasChanged(false),
-		randGenerator((std::default_random_engine::result_type)
-			std::chrono::system_clock::now().time_since_epoch().count())
+		: hasChanged(false)
 	{
 	}
 
@@ -54,19 +57,16 @@ namespace GENA
 
 		std::string paddedResType = resType + std::string(8 - resType.length(), ' ');
 
-		while (true)
+		const ResId id = hashPath(filename);
+		if (entries.count(id) != 0)
 		{
-			ResId id = randGenerator();
-			if (entries.count(id) == 0)
-			{
-				entries[id].filename = filename;
-				entries[id].resType = paddedResType;
-
-				filenameToId[filename] = id;
-				break;
-			}
+			throw std::runtime_error(filename + " and " + entries[id].filename + " hash to the same id, rename one of them");
 		}
 
+		entries[id].filename = filename;
+		entries[id].resType = paddedResType;
+		filenameToId[filename] = id;
+
 		hasChanged = true;
 	}
 
@@ -88,4 +88,169 @@ namespace GENA
 	{
 		return hasChanged;
 	}
+
+	std::vector<Index::ResId> Index::findDependencies(ResId id) const
+	{
+		const Entry& entry = entries.at(id);
+		std::vector<ResId> deps;
+
+		if (entry.resType == "btx     ")
+		{
+			deps = findModelDependencies(entry.filename);
+		}
+		else if (entry.resType == "room    ")
+		{
+			deps = findRoomDependencies(entry.filename);
+		}
+
+		std::sort(deps.begin(), deps.end());
+		deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+		return deps;
+	}
+
+	static void readModelInt(std::istream& in, int32_t& val)
+	{
+		in.read((char*)&val, sizeof(val));
+	}
+
+	static void readModelString(std::istream& in, std::string& val)
+	{
+		int32_t length = 0;
+		readModelInt(in, length);
+		if (!in || length < 0)
+		{
+			throw std::runtime_error("Corrupt model string");
+		}
+
+		std::vector<char> buffer(length);
+		in.read(buffer.data(), length);
+		val.assign(buffer.data(), length);
+	}
+
+	std::vector<Index::ResId> Index::findModelDependencies(const std::string& filename) const
+	{
+		std::vector<ResId> deps;
+
+		std::ifstream model(filename, std::ifstream::binary);
+		if (!model)
+		{
+			std::cerr << "Failed to open " << filename << " for dependency scanning\n";
+			return deps;
+		}
+
+		// Header: name, material, vertex and material buffer counts and three flags
+		std::string modelName;
+		int32_t numMaterials = 0;
+		int32_t skipped;
+		readModelString(model, modelName);
+		readModelInt(model, numMaterials);
+		for (int i = 0; i < 5; ++i)
+		{
+			readModelInt(model, skipped);
+		}
+
+		// Textures are looked up next to the models folder, the way the game does
+		size_t lastSlash = filename.find_last_of("/\\");
+		std::string modelDir = lastSlash == std::string::npos ? "" : filename.substr(0, lastSlash + 1);
+
+		for (int32_t i = 0; i < numMaterials; ++i)
+		{
+			std::string materialId;
+			readModelString(model, materialId);
+
+			for (int map = 0; map < 3; ++map)
+			{
+				std::string texture;
+				readModelString(model, texture);
+				if (texture.empty())
+				{
+					continue;
+				}
+
+				std::string texturePath = normalizePath(modelDir + "../textures/" + texture);
+				auto iter = filenameToId.find(texturePath);
+				if (iter == filenameToId.end())
+				{
+					std::cerr << filename << " uses untracked texture " << texturePath << '\n';
+					continue;
+				}
+
+				deps.push_back(iter->second);
+			}
+		}
+
+		return deps;
+	}
+
+	std::vector<Index::ResId> Index::findRoomDependencies(const std::string& filename) const
+	{
+		std::vector<ResId> deps;
+
+		std::ifstream room(filename);
+		if (!room)
+		{
+			std::cerr << "Failed to open " << filename << " for dependency scanning\n";
+			return deps;
+		}
+
+		std::string word;
+		while (room >> word)
+		{
+			if (word != "res:")
+			{
+				continue;
+			}
+
+			ResId res = 0;
+			room >> res;
+			if (entries.count(res) == 0)
+			{
+				std::cerr << filename << " places untracked resource " << res << '\n';
+				continue;
+			}
+
+			deps.push_back(res);
+		}
+
+		return deps;
+	}
+
+	std::string Index::normalizePath(const std::string& path)
+	{
+		std::vector<std::string> parts;
+		std::istringstream iss(path);
+		std::string part;
+
+		while (std::getline(iss, part, '/'))
+		{
+			if (part == "..")
+			{
+				if (!parts.empty() && parts.back() != "..")
+				{
+					parts.pop_back();
+				}
+				else
+				{
+					parts.push_back(part);
+				}
+			}
+			else if (!part.empty() && part != ".")
+			{
+				parts.push_back(part);
+			}
+		}
+
+		std::string result;
+		for (const auto& p : parts)
+		{
+			if (!result.empty())
+			{
+				result += '/';
+			}
+			result += p;
+		}
+
+		return result;
+	}
 }
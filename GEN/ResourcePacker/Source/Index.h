@@ -3,8 +3,8 @@
 #include <cstdint>
 #include <iostream>
 #include <map>
-#include <random>
 #include <string>
+#include <vector>
 
 namespace GENA
 {
@@ -25,25 +25,40 @@ namespace GENA
 
 		bool hasChanged;
 
-		std::default_random_engine randGenerator;
-
 	public:
 		Index();
 		void load(std::istream& indexFile);
 		void save(std::ostream& indexFile) const;
 
+		/**
+		 * Resources are identified by the hash of their path, see hashPath,
+		 * so code can name them with GENA_RES. Throws if the hash is taken
+		 * by another file.
+		 */
 		void addEntry(const std::string& filename, const std::string resType);
 		void removeEntry(const std::string& filename);
 
 		bool getHasChanged() const;
 
+		/**
+		 * Finds the tracked resources that id refers to: the textures of a
+		 * btx model and the objects placed in a room.
+		 */
+		std::vector<ResId> findDependencies(ResId id) const;
+
 		template <typename Pack>
 		void exportToPack(Pack& pack) const
 		{
 			for (const auto& entryPair : entries)
 			{
 				pack.addFile(entryPair.first, entryPair.second.filename, entryPair.second.resType);
+				pack.setDependencies(entryPair.first, findDependencies(entryPair.first));
 			}
 		}
+
+	private:
+		std::vector<ResId> findModelDependencies(const std::string& filename) const;
+		std::vector<ResId> findRoomDependencies(const std::string& filename) const;
+		static std::string normalizePath(const std::string& path);
 	};
 }
@@ -3,8 +3,16 @@
 #include <BinPacked.h>
 #include <ZipPacked.h>
 
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#endif
 
 void addFile(const char* filename, const char* resourceType)
 {
@@ -59,6 +67,24 @@ void addFile(const char* filename, const char* resourceType)
 	}
 }
 
+/**
+ * Puts the freshly written temp in place of filename in one step, so that
+ * anything watching the archive never sees it half written.
+ */
+static void replaceFile(const std::string& temp, const char* filename)
+{
+#ifdef _WIN32
+	bool replaced = MoveFileExA(temp.c_str(), filename, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	bool replaced = std::rename(temp.c_str(), filename) == 0;
+#endif
+
+	if (!replaced)
+	{
+		std::cerr << "Failed to replace \"" << filename << "\", the new archive is left in \"" << temp << "\".\n";
+	}
+}
+
 template <typename Pack>
 void createResourceArchive(const char* filename)
 {
@@ -75,7 +101,9 @@ void createResourceArchive(const char* filename)
 
 	index.exportToPack(pack);
 
-	pack.write(std::ofstream(filename, std::ios::binary | std::ios::trunc));
+	const std::string temp = std::string(filename) + ".tmp";
+	pack.write(std::ofstream(temp, std::ios::binary | std::ios::trunc));
+	replaceFile(temp, filename);
 }
 
 template <>
@@ -95,7 +123,9 @@ void createResourceArchive<GENA::BinPacked>(const char* filename)
 	index.exportToPack(pack);
 
 	pack.prepareFileInfo();
-	pack.write(std::ofstream(filename, std::ios::binary | std::ios::trunc));
+	const std::string temp = std::string(filename) + ".tmp";
+	pack.write(std::ofstream(temp, std::ios::binary | std::ios::trunc));
+	replaceFile(temp, filename);
 }
 
 void removeFile(const char* filename)
@@ -3,13 +3,12 @@
 #include "ModelBinaryLoader.h"
 
 #include <IGraphics.h>
+#include <Trace.h>
 
 #include <iostream>
 
 using namespace GENA;
 
-bool g_CText = true;
-
 GraphicsCache::~GraphicsCache()
 {
 	clear();
@@ -24,8 +23,7 @@ void GraphicsCache::doWork()
 
 		for (auto& modRem : removeModelQueue)
 		{
-			if(g_CText)
-				std::cout << "Removing graphics resource: " << modRem.modelId << std::endl;
+			GENA_TRACE(Trace::Info, Trace::GraphicsRemove, modRem.resId, 0);
 
 			graphics->releaseModel(modRem.modelId.c_str());
 			
@@ -44,8 +42,7 @@ void GraphicsCache::doWork()
 
 		for (auto& texRem : removeTextureQueue)
 		{
-			if(g_CText)
-				std::cout << "Removing graphics resource: " << texRem.textureId << std::endl;
+			GENA_TRACE(Trace::Info, Trace::GraphicsRemove, texRem.resId, 0);
 
 			graphics->releaseTexture(texRem.textureId.c_str());
 			
@@ -64,10 +61,9 @@ void GraphicsCache::doWork()
 
 		for (auto& texReq : createTextureQueue)
 		{
-			if(g_CText)
-				std::cout << "Uploading graphics resource: " << texReq.textureId << std::endl;
-
 			const Buffer& buff = texReq.resource->getBuffer();
+			GENA_TRACE(Trace::Info, Trace::GraphicsUpload, texReq.resource->getId(), buff.size());
+
 			graphics->createTexture(texReq.textureId.c_str(), buff.data(), buff.size());
 			
 			if (textureResMap.count(texReq.textureId) > 0)
@@ -75,7 +71,7 @@ void GraphicsCache::doWork()
 				throw std::runtime_error("Texture " + texReq.textureId + " already loaded");
 			}
 			
-			std::shared_ptr<GraphicsHandle> resHandle(new (graphAlloc.alloc()) GraphicsHandle(texReq.textureId, "Texture", this), GRHAllocDeleter(graphAlloc));
+			std::shared_ptr<GraphicsHandle> resHandle(new (graphAlloc.alloc()) GraphicsHandle(texReq.textureId, "Texture", texReq.resource->getId(), this), GRHAllocDeleter(graphAlloc));
 			
 			textureResMap[texReq.textureId] = resHandle;
 			
@@ -112,10 +108,9 @@ void GraphicsCache::doWork()
 
 				continue;
 			}
-			if(g_CText)
-				std::cout << "Uploading graphics resource: " << modReq->modelId << std::endl;
-
 			const Buffer& buff = modReq->resource->getBuffer();
+			GENA_TRACE(Trace::Info, Trace::GraphicsUpload, modReq->resource->getId(), buff.size());
+
 
 			ModelBinaryLoader loader;
 			loader.loadBinaryFromMemory(buff.data(), buff.size());
@@ -170,7 +165,7 @@ void GraphicsCache::doWork()
 				throw std::runtime_error("Model " + modReq->modelId + " already loaded");
 			}
 
-			std::shared_ptr<GraphicsHandle> resHandle(new (graphAlloc.alloc()) GraphicsHandle(modReq->modelId, "Model", this), GRHAllocDeleter(graphAlloc));
+			std::shared_ptr<GraphicsHandle> resHandle(new (graphAlloc.alloc()) GraphicsHandle(modReq->modelId, "Model", modReq->resource->getId(), this), GRHAllocDeleter(graphAlloc));
 			for (auto child : modReq->children)
 			{
 				resHandle->addChild(child);
@@ -16,8 +16,6 @@
 #include <string>
 #include <vector>
 
-extern bool g_CText;
-
 class IGraphics;
 
 typedef std::function<void(std::shared_ptr<GraphicsHandle>)> GCreatedHandler;
@@ -53,12 +51,14 @@ struct TextureReq
 struct ModelRem
 {
 	std::string modelId;
+	GENA::ResourceHandle::ResId resId;
 	GRemovedHandler completionHandler;
 };
 
 struct TextureRem
 {
 	std::string textureId;
+	GENA::ResourceHandle::ResId resId;
 	GRemovedHandler completionHandler;
 };
 	
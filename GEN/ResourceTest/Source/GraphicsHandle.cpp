@@ -6,12 +6,12 @@ GraphicsHandle::~GraphicsHandle()
 {
 	if (resType == "Model")
 	{
-		ModelRem rem = { graphicsId };
+		ModelRem rem = { graphicsId, resId };
 		cache->queueRemoveModel(rem);
 	}
 	else if (resType == "Texture")
 	{
-		TextureRem rem = { graphicsId };
+		TextureRem rem = { graphicsId, resId };
 		cache->queueRemoveTexture(rem);
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ResourceHandle.h>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,13 +13,15 @@ class GraphicsHandle
 private:
 	std::string graphicsId;
 	std::string resType;
+	GENA::ResourceHandle::ResId resId;
 	GraphicsCache* cache;
 	std::vector<std::shared_ptr<GraphicsHandle>> children;
 
 public:
-	GraphicsHandle(std::string graphicsId, std::string resType, GraphicsCache* cache)
+	GraphicsHandle(std::string graphicsId, std::string resType, GENA::ResourceHandle::ResId resId, GraphicsCache* cache)
 		: graphicsId(graphicsId),
 		resType(resType),
+		resId(resId),
 		cache(cache)
 	{
 	}
@@ -1,105 +1,117 @@
 #include "RoomResourceLoader.h"
 
-#include <sstream>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <cstring>
 
 typedef GENA::ResourceHandle::ResId ResId;
 
-uint64_t RoomResourceLoader::getLoadedResourceSize(const GENA::Buffer& rawBuffer)
+bool RoomResourceLoader::parseRoom(const GENA::Buffer& rawBuffer, std::vector<RoomObject>& objects)
 {
-	std::istringstream iss(std::string(rawBuffer.data(), rawBuffer.size()));
+	// Read in place, the text is parsed once and never copied
+	boost::iostreams::stream<boost::iostreams::array_source> iss(rawBuffer.data(), rawBuffer.size());
 	std::string word;
 
-	uint32_t numObjs = 0;
-
 	iss >> word;
 	while (iss)
 	{
+		RoomObject obj;
+
 		if (word != "-")
 		{
-			return 0;
+			return false;
 		}
 		iss >> word;
 		if (word != "res:")
 		{
-			return 0;
+			return false;
 		}
-		ResId res = 0;
-		iss >> res;
+		iss >> obj.id;
 		iss >> word;
 		if (word != "x:")
 		{
-			return 0;
+			return false;
 		}
-		float x, y, z;
-		iss >> x;
+		iss >> obj.x;
 		iss >> word;
 		if (word != "y:")
 		{
-			return 0;
+			return false;
 		}
-		iss >> y;
+		iss >> obj.y;
 		iss >> word;
 		if (word != "z:")
 		{
-			return 0;
+			return false;
 		}
-		iss >> z;
+		iss >> obj.z;
 		iss >> word;
 
-		++numObjs;
+		objects.push_back(obj);
 	}
 
-	return sizeof(uint32_t) + sizeof(RoomObject) * numObjs;
+	return true;
 }
 
-bool RoomResourceLoader::loadResource(const GENA::Buffer& rawBuffer, std::shared_ptr<GENA::ResourceHandle> handle)
+uint64_t RoomResourceLoader::getLoadedResourceSize(const GENA::Buffer& rawBuffer)
 {
-	std::istringstream iss(std::string(rawBuffer.data(), rawBuffer.size()));
-	std::string word;
+	std::vector<RoomObject> objects;
+	if (!parseRoom(rawBuffer, objects))
+	{
+		return 0;
+	}
+
+	return sizeof(uint32_t) + sizeof(RoomObject) * objects.size();
+}
 
-	uint32_t numObjs = 0;
+bool RoomResourceLoader::loadResource(const GENA::Buffer& rawBuffer, std::shared_ptr<GENA::ResourceHandle> handle)
+{
+	std::vector<RoomObject> objects;
+	if (!parseRoom(rawBuffer, objects))
+	{
+		return false;
+	}
 
-	char* writePos = handle->getBuffer().data() + sizeof(uint32_t);
-	RoomObject* roomWritePos = (RoomObject*)writePos;
+	writeRoom(objects, handle->getBuffer().data());
+	return true;
+}
 
-	iss >> word;
-	while (iss)
+std::shared_ptr<GENA::ResourceHandle> RoomResourceLoader::load(const GENA::Buffer& rawBuffer, GENA::ILoadTarget& target)
+{
+	std::vector<RoomObject> objects;
+	if (!parseRoom(rawBuffer, objects))
 	{
-		if (word != "-")
-		{
-			return false;
-		}
-		iss >> word;
-		if (word != "res:")
-		{
-			return false;
-		}
-		iss >> roomWritePos->id;
-		iss >> word;
-		if (word != "x:")
-		{
-			return false;
-		}
-		iss >> roomWritePos->x;
-		iss >> word;
-		if (word != "y:")
-		{
-			return false;
-		}
-		iss >> roomWritePos->y;
-		iss >> word;
-		if (word != "z:")
-		{
-			return false;
-		}
-		iss >> roomWritePos->z;
-		iss >> word;
+		return nullptr;
+	}
 
-		++roomWritePos;
-		++numObjs;
+	std::shared_ptr<GENA::ResourceHandle> handle = target.allocate(sizeof(uint32_t) + sizeof(RoomObject) * objects.size());
+	if (handle)
+	{
+		writeRoom(objects, handle->getBuffer().data());
 	}
 
-	*(uint32_t*)(handle->getBuffer().data()) = numObjs;
+	return handle;
+}
 
-	return true;
+void RoomResourceLoader::writeRoom(const std::vector<RoomObject>& objects, char* dest)
+{
+	*(uint32_t*)dest = (uint32_t)objects.size();
+	if (!objects.empty())
+	{
+		memcpy(dest + sizeof(uint32_t), objects.data(), sizeof(RoomObject) * objects.size());
+	}
 }
+
+void RoomResourceLoader::getRoomObjects(const GENA::ResourceHandle& room, std::vector<ResId>& members)
+{
+	const GENA::Buffer& buff = room.getBuffer();
+
+	uint32_t numObjs = *(const uint32_t*)buff.data();
+	const RoomObject* objs = (const RoomObject*)(buff.data() + sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < numObjs; ++i)
+	{
+		members.push_back(objs[i].id);
+	}
+}
\ No newline at end of file
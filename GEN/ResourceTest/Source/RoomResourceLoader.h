@@ -2,6 +2,8 @@
 
 #include <IResourceLoader.h>
 
+#include <vector>
+
 struct RoomObject
 {
 	GENA::ResourceHandle::ResId id;
@@ -15,4 +17,20 @@ public:
 	bool useRawFile() override { return false; }
 	uint64_t getLoadedResourceSize(const GENA::Buffer& rawBuffer) override;
 	bool loadResource(const GENA::Buffer& rawBuffer, std::shared_ptr<GENA::ResourceHandle> handle) override;
+	uint32_t getVersion() override { return 1; }
+
+	/**
+	 * Parses the room once and copies the objects into cache memory
+	 * sized for them.
+	 */
+	std::shared_ptr<GENA::ResourceHandle> load(const GENA::Buffer& rawBuffer, GENA::ILoadTarget& target) override;
+
+	/**
+	 * Resource set extractor listing the objects of a loaded room.
+	 */
+	static void getRoomObjects(const GENA::ResourceHandle& room, std::vector<GENA::ResourceHandle::ResId>& members);
+
+private:
+	static bool parseRoom(const GENA::Buffer& rawBuffer, std::vector<RoomObject>& objects);
+	static void writeRoom(const std::vector<RoomObject>& objects, char* dest);
 };
\ No newline at end of file
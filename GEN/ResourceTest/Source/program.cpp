@@ -14,6 +14,9 @@
 
 #include <ResourceZipFile.h>
 #include <ResourceCache.h>
+#include <PathHash.h>
+#include <RoomPrefetcher.h>
+#include <Trace.h>
 
 #include <StackAllocatorSingleThreaded.h>
 
@@ -23,6 +26,7 @@
 #include <cmath>
 #include <condition_variable>
 #include <forward_list>
+#include <fstream>
 #include <sstream>
 
 #include <vld.h>
@@ -88,10 +92,10 @@ ResId decideRoomRes(int roomNr)
 {
 	const static ResId rooms[] =
 	{
-		2784892733,
-		2356309912,
-		970641542,
-		2460769868,
+		GENA_RES("assets/rooms/room1.txt"),
+		GENA_RES("assets/rooms/room2.txt"),
+		GENA_RES("assets/rooms/room3.txt"),
+		GENA_RES("assets/rooms/room4.txt"),
 	};
 	const static size_t numRooms = arrSize(rooms);
 	roomNr %= numRooms;
@@ -102,11 +106,40 @@ ResId decideRoomRes(int roomNr)
 	return rooms[roomNr];
 }
 
+ResId resolveRoom(int roomNr, void* userData)
+{
+	return decideRoomRes(roomNr);
+}
+
 const static float roomSize = 1000.f;
 
+std::string roomSetName(int roomNr)
+{
+	return "room " + std::to_string((long long)roomNr);
+}
+
+void cachePressureChanged(ResourceCache::PressureLevel level, uint64_t allocated, uint64_t cacheSize, void* userData)
+{
+	const char* levelNames[] = { "normal", "high", "critical" };
+	std::cerr << "Cache pressure " << levelNames[level] << ": " << allocated << " of " << cacheSize << " B" << std::endl;
+}
+
+void roomSetLoaded(const std::string& name, bool complete, void* userData)
+{
+	if (!complete)
+	{
+		std::cerr << "Some resources of " << name << " failed to load" << std::endl;
+	}
+}
+
 void loadRoom(int roomNr)
 {
 	ResId roomId = decideRoomRes(roomNr);
+
+	// Keeps the whole room in the cache until it is unloaded
+	cache.defineSetFrom(roomSetName(roomNr), roomId, &RoomResourceLoader::getRoomObjects);
+	cache.loadSet(roomSetName(roomNr), &roomSetLoaded, nullptr);
+
 	std::shared_ptr<ResourceHandle> roomRes = cache.getHandle(roomId);
 	const Buffer& buff = roomRes->getBuffer();
 
@@ -117,7 +150,7 @@ void loadRoom(int roomNr)
 
 	for (uint32_t i = 0; i < numObjs; ++i)
 	{
-		std::string resName = cache.findPath(readObjPos->id);
+		const std::string resName = cache.findPath(readObjPos->id);
 		float x = readObjPos->x + roomNr * roomSize;
 		float y = readObjPos->y;
 		float z = readObjPos->z;
@@ -144,11 +177,23 @@ void unloadRoom(int roomNr)
 		graphics->eraseModelInstance(m.id);
 	}
 	rooms.erase(roomNr);
+
+	cache.releaseSet(roomSetName(roomNr));
 }
 
 int main(int argc, char* argv[])
 {
+	// Off until toggled with L
+	Trace::setLevel(Trace::Off);
+	Trace::setThreadName("Main");
+
+	cache.setDecodedCacheDir("decodedCache");
+	cache.setPressureCallback(&cachePressureChanged, nullptr);
+	cache.setBackgroundEviction(true);
+	cache.setDeferredFree(true);
 	cache.init();
+	// Replay with CacheSimulator to tune the cache size
+	cache.startAccessTrace("accessTrace.bin");
 	cache.registerLoader(std::shared_ptr<IResourceLoader>(new RoomResourceLoader()));
 
 	GENA::StackAllocatorSingleThreaded stack(10 * 1024);
@@ -189,7 +234,7 @@ int main(int argc, char* argv[])
 				break;
 
 			case 'L':
-				g_CText = !g_CText;
+				Trace::setLevel(Trace::getLevel() == Trace::Off ? Trace::Verbose : Trace::Off);
 				break;
 
 			default:
@@ -275,7 +320,7 @@ int main(int argc, char* argv[])
 	GraphicsCache gCache(graphics, &cache, &stack);
 	ggCache = &gCache;
 
-	ResId skyDomeId = cache.findByPath("assets/textures/Skybox1_COLOR.dds");
+	ResId skyDomeId = GENA_RES("assets/textures/Skybox1_COLOR.dds");
 	std::shared_ptr<GraphicsHandle> skyDomeGRes;
 
 	gCache.asyncLoadTexture("SKYDOME", skyDomeId,
@@ -290,6 +335,10 @@ int main(int argc, char* argv[])
 	loadRoom(currRoom);
 	loadRoom(currRoom + 1);
 
+	// The neighbouring rooms are always loaded, this reaches further ahead
+	RoomPrefetcher prefetcher(cache, roomSize, &resolveRoom, nullptr);
+	prefetcher.setLookahead(3);
+
 	typedef std::chrono::steady_clock cl;
 
 	float xPos = 0;
@@ -342,6 +391,7 @@ int main(int argc, char* argv[])
 
 		const static float moveSpeed = 500.f;
 		xPos += dt * direction * moveSpeed;
+		prefetcher.update(xPos, direction * moveSpeed);
 
 		int room = (int)floor(xPos / roomSize);
 		if (room != currRoom)
@@ -405,6 +455,9 @@ int main(int argc, char* argv[])
 
 		graphics->drawFrame();
 
+		// Handles dropped while unloading rooms are freed here, not mid-frame
+		cache.collectGarbage();
+
 		std::this_thread::sleep_for(std::chrono::milliseconds(15) - frameTime);
 	}
 
@@ -421,6 +474,15 @@ int main(int argc, char* argv[])
 	gCache.doWork();
 	gCache.clear();
 
+	cache.exportTrace("trace.json");
+
+	CacheMetrics::Snapshot metrics = cache.getMetrics();
+	std::ofstream metricsOut("cacheMetrics.csv");
+	CacheMetrics::writeCounterHeader(metricsOut);
+	CacheMetrics::writeCounterRow(metricsOut, metrics);
+	metricsOut << '\n';
+	CacheMetrics::writeLatencyCsv(metricsOut, metrics);
+
 	IGraphics::deleteGraphics(graphics);
 	win.destroy();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <utility>
 
 namespace GENA
 {
@@ -9,6 +10,7 @@ namespace GENA
 	private:
 		char* bufData;
 		size_t bufSize;
+		bool ownsData;
 
 	public:
 		Buffer();
@@ -18,7 +20,14 @@ namespace GENA
 
 		~Buffer();
 
+		/**
+		 * Wraps memory owned by someone else, like a mapped file. The
+		 * buffer never frees it and must not outlive it.
+		 */
+		static Buffer view(const char* data, size_t size);
+
 		size_t size() const;
+		bool isView() const;
 		void clear();
 
 		char* data();
@@ -38,37 +47,46 @@ namespace GENA
 
 	inline Buffer::Buffer()
 		: bufData(nullptr),
-		bufSize(0)
+		bufSize(0),
+		ownsData(true)
 	{
 	}
 
 	inline Buffer::Buffer(size_t size)
 		: bufData(new char[size]),
-		bufSize(size)
+		bufSize(size),
+		ownsData(true)
 	{
 	}
 
 	inline Buffer::Buffer(char* data, size_t size)
 		: bufData(data),
-		bufSize(size)
+		bufSize(size),
+		ownsData(true)
 	{
 	}
 
 	inline Buffer::Buffer(Buffer&& other)
 		: bufData(other.bufData),
-		bufSize(other.bufSize)
+		bufSize(other.bufSize),
+		ownsData(other.ownsData)
 	{
 		other.bufData = nullptr;
 		other.bufSize = 0;
+		other.ownsData = true;
 	}
 
 	inline Buffer::~Buffer()
 	{
-		if (bufData)
-		{
-			delete[] bufData;
-			bufData = nullptr;
-		}
+		clear();
+	}
+
+	inline Buffer Buffer::view(const char* data, size_t size)
+	{
+		// Views are read-only even though data() hands out a char*
+		Buffer result(const_cast<char*>(data), size);
+		result.ownsData = false;
+		return result;
 	}
 
 	inline size_t Buffer::size() const
@@ -76,13 +94,22 @@ namespace GENA
 		return bufSize;
 	}
 
+	inline bool Buffer::isView() const
+	{
+		return !ownsData;
+	}
+
 	inline void Buffer::clear()
 	{
 		if (bufData)
 		{
-			delete[] bufData;
+			if (ownsData)
+			{
+				delete[] bufData;
+			}
 			bufData = nullptr;
 			bufSize = 0;
+			ownsData = true;
 		}
 	}
 
@@ -100,6 +127,9 @@ namespace GENA
 	{
 		std::swap(bufData, other.bufData);
 		std::swap(bufSize, other.bufSize);
+		std::swap(ownsData, other.ownsData);
+
+		return *this;
 	}
 
 	inline char& Buffer::operator[](size_t pos)
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+#define GENA_HAS_CONSTEXPR
+#define GENA_CONSTEXPR constexpr
+#else
+#define GENA_CONSTEXPR inline
+#endif
+
+/**
+ * Id of the resource packed from path, hashed at compile time where the
+ * compiler can. Without constexpr the hash is left to the optimizer, which
+ * folds it for literals as well.
+ */
+#ifdef GENA_HAS_CONSTEXPR
+#define GENA_RES(path) (std::integral_constant<GENA::PathHash, GENA::hashPath(path)>::value)
+#else
+#define GENA_RES(path) (GENA::hashPath(path))
+#endif
+
+namespace GENA
+{
+	typedef uint32_t PathHash;
+
+	static const PathHash pathHashBasis = 2166136261u;
+	static const PathHash pathHashPrime = 16777619u;
+
+	GENA_CONSTEXPR char normalizePathChar(char c)
+	{
+		return c == '\\' ? '/' : (c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c);
+	}
+
+	/**
+	 * 32 bit FNV-1a hash of a resource path, the id the resource is packed
+	 * with. Paths are normalised while hashing, backslashes count as slashes
+	 * and letters as lower case, so the spellings Windows accepts for a
+	 * file all give the same id.
+	 *
+	 * A single recursive expression, as C++11 constexpr functions have to be.
+	 */
+	GENA_CONSTEXPR PathHash hashPath(const char* path, PathHash hash = pathHashBasis)
+	{
+		return *path == '\0' ? hash
+			: hashPath(path + 1, (hash ^ (unsigned char)normalizePathChar(*path)) * pathHashPrime);
+	}
+
+	inline PathHash hashPath(const std::string& path)
+	{
+		PathHash hash = pathHashBasis;
+		for (char c : path)
+		{
+			hash = (hash ^ (unsigned char)normalizePathChar(c)) * pathHashPrime;
+		}
+		return hash;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace GENA
+{
+	/**
+	 * Resource types are eight characters, padded with spaces, like
+	 * "dds     ". Packed into an integer, the characters in memory order, a
+	 * type takes one compare to match and is stored in archives as is.
+	 */
+	typedef uint64_t ResourceType;
+
+	static const size_t resourceTypeLength = sizeof(ResourceType);
+
+	inline ResourceType packResourceType(const std::string& type)
+	{
+		char chars[resourceTypeLength];
+		std::memset(chars, ' ', resourceTypeLength);
+		std::memcpy(chars, type.data(), std::min(type.size(), resourceTypeLength));
+
+		ResourceType packed;
+		std::memcpy(&packed, chars, resourceTypeLength);
+		return packed;
+	}
+
+	inline std::string unpackResourceType(ResourceType type)
+	{
+		char chars[resourceTypeLength];
+		std::memcpy(chars, &type, resourceTypeLength);
+		return std::string(chars, resourceTypeLength);
+	}
+}